@@ -1,9 +1,13 @@
 struct buf;
 struct context;
 struct file;
+struct hist;
 struct inode;
 struct pipe;
 struct proc;
+struct procinfo;
+struct rwlock;
+struct exitstats;
 struct spinlock;
 struct sleeplock;
 struct stat;
@@ -55,6 +59,17 @@ int             writei(struct inode*, int, uint64, uint, uint);
 void            itrunc(struct inode*);
 void            ireclaim(int);
 
+// hist.c
+int             hist_bucket(uint64);
+void            hist_add(struct hist*, uint64);
+void            hist_merge(struct hist*, struct hist*);
+
+// ipc.c
+void            ipcinit(void);
+void            ipc_exit(struct proc*);
+int             ksend(int, uint64, int);
+int             krecv(uint64, uint64, int);
+
 // kalloc.c
 void*           kalloc(void);
 void            kfree(void *);
@@ -66,6 +81,16 @@ void            log_write(struct buf*);
 void            begin_op(void);
 void            end_op(void);
 
+// pgroup.c
+void            pgroupinit(void);
+int             pg_throttled(int);
+void            pg_charge(int, uint64);
+int             ksetquota(int, uint64, uint64);
+int             kgetpgroupinfo(int, uint64);
+int             ksetpgid(int, int);
+void            pg_fork(struct proc*, struct proc*);
+void            pg_leave(int);
+
 // pipe.c
 int             pipealloc(struct file**, struct file**);
 void            pipeclose(struct pipe*, int);
@@ -74,6 +99,7 @@ int             pipewrite(struct pipe*, uint64, int);
 
 // printf.c
 int             printf(char*, ...) __attribute__ ((format (printf, 1, 2)));
+int             snprintf(char*, int, char*, ...) __attribute__ ((format (printf, 3, 4)));
 void            panic(char*) __attribute__((noreturn));
 void            printfinit(void);
 
@@ -94,14 +120,71 @@ void            procinit(void);
 void            scheduler(void) __attribute__((noreturn));
 void            sched(void);
 void            sleep(void*, struct spinlock*);
+void            sleepio(void*, struct spinlock*);
 void            userinit(void);
-int             kwait(uint64);
+int             kwait(uint64, uint64);
 void            wakeup(void*);
+void            wakeupproc(struct proc*, void*);
 void            yield(void);
+void            preempt(void);
+int             kyield_to(int);
+int             timeslice_up(struct proc*);
+int             ksetpriority(int, int);
+int             kgetpriority(int);
+int             kschedctl(int, int);
+void            starvation_watch(void);
+void            fillprocinfo(struct proc *, struct procinfo *);
+void            acct_trapenter(struct proc *);
+void            acct_trapexit(struct proc *);
+int             kgetwaithist(int, int, uint64);
+void            cpustat_tick(void);
+int             kgetcpustats(uint64, int);
+int             interactivity(struct proc*);
 int             either_copyout(int user_dst, uint64 dst, void *src, uint64 len);
 int             either_copyin(void *dst, int user_src, uint64 src, uint64 len);
 void            procdump(void);
 
+// prof.c
+extern uint64   prof_interval;
+void            profinit(void);
+int             prof_setinterval(int);
+void            prof_sample(void);
+int             kgetprofile(uint64, int);
+uint64          prof_dropped(void);
+
+// strace.c
+struct straceent;
+extern int      systime_on;
+extern int      strace_pid;
+void            straceinit(void);
+int             strace_set(int);
+void            sysstat_add(struct proc*, int, uint64);
+void            strace_enter(struct straceent*, struct proc*, int);
+void            strace_exit(struct straceent*, uint64, uint64);
+int             ksysstat(int, uint64);
+int             kgetstrace(uint64, int);
+uint64          strace_dropped(void);
+
+// procfs.c
+void            loadavg_tick(void);
+int             procfs_match(char*);
+struct file*    procfs_open(char*);
+int             procfs_read(struct file*, uint64, int);
+void            procfs_stat(struct file*, struct stat*);
+
+// schedstat.c
+void            schedstatinit(void);
+void            exitstat_add(struct proc*);
+void            exitstats_get(struct exitstats*, int);
+int             kexitstats(uint64, int);
+
+// statspage.c
+void            statspageinit(void);
+void            statspage_update(void);
+int             statsmapped(pagetable_t);
+int             mapstats(pagetable_t);
+uint64          kmapstats(void);
+
 // swtch.S
 void            swtch(struct context*, struct context*);
 
@@ -109,9 +192,32 @@ void            swtch(struct context*, struct context*);
 void            acquire(struct spinlock*);
 int             holding(struct spinlock*);
 void            initlock(struct spinlock*, char*);
+void            initlock_kind(struct spinlock*, char*, int);
 void            release(struct spinlock*);
 void            push_off(void);
 void            pop_off(void);
+int             klockstat(uint64, int);
+int             lockstat_class(char*);
+void            lockstat_acquire(int, uint64);
+void            lockstat_sleep(struct spinlock*, int, int, uint64);
+void            lockbenchinit(void);
+int             klockbench(int, int, int);
+
+// rwlock.c
+void            initrwlock(struct rwlock*, char*);
+void            acquireread(struct rwlock*);
+void            releaseread(struct rwlock*);
+void            acquirewrite(struct rwlock*);
+void            releasewrite(struct rwlock*);
+
+// rcu.c
+void            rcu_read_lock(void);
+void            rcu_read_unlock(void);
+void            rcu_qs(void);
+void            rcu_idle(int);
+void            synchronize_rcu(void);
+#define rcu_deref(p)     __atomic_load_n(&(p), __ATOMIC_ACQUIRE)
+#define rcu_assign(p, v) __atomic_store_n(&(p), (v), __ATOMIC_RELEASE)
 
 // sleeplock.c
 void            acquiresleep(struct sleeplock*);
@@ -136,6 +242,12 @@ int             fetchstr(uint64, char*, int);
 int             fetchaddr(uint64, uint64*);
 void            syscall();
 
+// timer.c
+void            timerqinit(void);
+void            timer_program(struct cpu*);
+void            timer_expire(struct cpu*, uint64);
+int             knanosleep(uint64);
+
 // trap.c
 extern uint     ticks;
 void            trapinit(void);
@@ -75,6 +75,8 @@ fileclose(struct file *f)
 
   if(ff.type == FD_PIPE){
     pipeclose(ff.pipe, ff.writable);
+  } else if(ff.type == FD_PROC){
+    kfree(ff.procbuf);
   } else if(ff.type == FD_INODE || ff.type == FD_DEVICE){
     begin_op();
     iput(ff.ip);
@@ -98,6 +100,12 @@ filestat(struct file *f, uint64 addr)
       return -1;
     return 0;
   }
+  if(f->type == FD_PROC){
+    procfs_stat(f, &st);
+    if(copyout(p->pagetable, addr, (char *)&st, sizeof(st)) < 0)
+      return -1;
+    return 0;
+  }
   return -1;
 }
 
@@ -122,6 +130,8 @@ fileread(struct file *f, uint64 addr, int n)
     if((r = readi(f->ip, 1, addr, f->off, n)) > 0)
       f->off += r;
     iunlock(f->ip);
+  } else if(f->type == FD_PROC){
+    r = procfs_read(f, addr, n);
   } else {
     panic("fileread");
   }
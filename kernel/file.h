@@ -1,12 +1,15 @@
 struct file {
-  enum { FD_NONE, FD_PIPE, FD_INODE, FD_DEVICE } type;
+  enum { FD_NONE, FD_PIPE, FD_INODE, FD_DEVICE, FD_PROC } type;
   int ref; // reference count
   char readable;
   char writable;
   struct pipe *pipe; // FD_PIPE
   struct inode *ip;  // FD_INODE and FD_DEVICE
-  uint off;          // FD_INODE
+  uint off;          // FD_INODE and FD_PROC
   short major;       // FD_DEVICE
+  char *procbuf;     // FD_PROC: the text generated at open
+  uint proclen;
+  short proctype;    // FD_PROC: T_FILE or T_DIR
 };
 
 #define major(dev)  ((dev) >> 16 & 0xFFFF)
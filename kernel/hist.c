@@ -0,0 +1,48 @@
+//
+// Log2 histograms (see hist.h).
+// Callers provide any locking.
+//
+
+#include "types.h"
+#include "riscv.h"
+#include "hist.h"
+#include "defs.h"
+
+// Index of the bucket that holds v.
+int
+hist_bucket(uint64 v)
+{
+  int i = 0;
+
+  while(v != 0 && i < NHIST - 1){
+    v >>= 1;
+    i++;
+  }
+  return i;
+}
+
+void
+hist_add(struct hist *h, uint64 v)
+{
+  if(h->count == 0 || v < h->min)
+    h->min = v;
+  h->count++;
+  h->sum += v;
+  if(v > h->max)
+    h->max = v;
+  h->bucket[hist_bucket(v)]++;
+}
+
+// Add the counts of src into dst.
+void
+hist_merge(struct hist *dst, struct hist *src)
+{
+  if(src->count > 0 && (dst->count == 0 || src->min < dst->min))
+    dst->min = src->min;
+  dst->count += src->count;
+  dst->sum += src->sum;
+  if(src->max > dst->max)
+    dst->max = src->max;
+  for(int i = 0; i < NHIST; i++)
+    dst->bucket[i] += src->bucket[i];
+}
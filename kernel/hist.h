@@ -0,0 +1,17 @@
+// Log2 histograms of durations (or other counts), kept by the
+// kernel and copied out to user space as-is.
+
+#ifndef HIST_H
+#define HIST_H
+
+#define NHIST 32
+
+struct hist {
+  uint64 count;          // number of values added
+  uint64 sum;
+  uint64 max;
+  uint64 min;            // valid once count > 0
+  uint64 bucket[NHIST];  // bucket[0]: v == 0; bucket[i]: 2^(i-1) <= v < 2^i
+};
+
+#endif // HIST_H
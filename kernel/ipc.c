@@ -0,0 +1,161 @@
+//
+// Synchronous (rendezvous) message passing between processes.
+//
+// send() blocks until the receiver has taken the message, and
+// recv() blocks until some process sends to it. A blocked sender
+// hands its CPU and the rest of its time slice straight to the
+// receiver (L4-style), so a client/server round trip doesn't
+// detour through whatever the scheduling policy would pick.
+//
+
+#include "types.h"
+#include "param.h"
+#include "memlayout.h"
+#include "riscv.h"
+#include "spinlock.h"
+#include "proc.h"
+#include "defs.h"
+
+extern struct proc proc[NPROC];
+
+// protects the ipc_* fields of every proc.
+// must be acquired before wait_lock and any p->lock.
+struct spinlock ipc_lock;
+
+void
+ipcinit(void)
+{
+  initlock(&ipc_lock, "ipc");
+}
+
+// Is there a live process with this pid?
+// Caller must hold ipc_lock.
+static int
+ipc_alive(int pid)
+{
+  struct proc *p;
+
+  for(p = proc; p < &proc[NPROC]; p++){
+    acquire(&p->lock);
+    if(p->pid == pid && p->state != UNUSED && p->state != ZOMBIE){
+      release(&p->lock);
+      return 1;
+    }
+    release(&p->lock);
+  }
+  return 0;
+}
+
+// p is exiting: drop its send/recv state and wake any process
+// blocked in send() to it or in recv() from it, so that they see
+// it is gone and fail. Caller must hold ipc_lock until p is a
+// ZOMBIE, or a woken peer could still find p alive and sleep again.
+void
+ipc_exit(struct proc *p)
+{
+  struct proc *rp;
+
+  p->ipc_state = IPC_IDLE;
+  p->ipc_peer = 0;
+  p->ipc_len = 0;
+
+  for(rp = proc; rp < &proc[NPROC]; rp++){
+    if(rp->ipc_state != IPC_IDLE && rp->ipc_peer == p->pid)
+      wakeup(&rp->ipc_state);
+  }
+}
+
+// Send n bytes at user address addr to process pid.
+// Returns n once pid has received the message, or -1.
+int
+ksend(int pid, uint64 addr, int n)
+{
+  struct proc *p = myproc();
+  struct proc *rp;
+  char buf[IPCMSG];
+
+  if(pid <= 0 || pid == p->pid || n < 0 || n > IPCMSG)
+    return -1;
+  if(copyin(p->pagetable, buf, addr, n) < 0)
+    return -1;
+
+  acquire(&ipc_lock);
+  memmove(p->ipc_msg, buf, n);
+  p->ipc_len = n;
+  p->ipc_peer = pid;
+  p->ipc_state = IPC_SEND;
+
+  // If the receiver is already waiting, wake it.
+  for(rp = proc; rp < &proc[NPROC]; rp++){
+    if(rp->pid == pid && rp->ipc_state == IPC_RECV &&
+       (rp->ipc_peer == 0 || rp->ipc_peer == p->pid))
+      wakeup(&rp->ipc_state);
+  }
+
+  while(p->ipc_state == IPC_SEND){
+    if(killed(p) || !ipc_alive(pid)){
+      p->ipc_state = IPC_IDLE;
+      release(&ipc_lock);
+      return -1;
+    }
+    // Block, giving this CPU to the receiver.
+    p->donate_to = pid;
+    sleep(&p->ipc_state, &ipc_lock);
+  }
+  release(&ipc_lock);
+
+  return n;
+}
+
+// Receive a message of at most n bytes into user address addr.
+// *fromaddr holds the pid to receive from, or 0 for anyone; it
+// is overwritten with the sender's pid.
+// Returns the message length, or -1.
+int
+krecv(uint64 fromaddr, uint64 addr, int n)
+{
+  struct proc *p = myproc();
+  struct proc *sp;
+  char buf[IPCMSG];
+  int from, len;
+
+  if(n < 0)
+    return -1;
+  if(copyin(p->pagetable, (char *)&from, fromaddr, sizeof(from)) < 0)
+    return -1;
+
+  acquire(&ipc_lock);
+  for(;;){
+    // Look for a sender blocked on us.
+    for(sp = proc; sp < &proc[NPROC]; sp++){
+      if(sp->ipc_state == IPC_SEND && sp->ipc_peer == p->pid &&
+         (from == 0 || sp->pid == from))
+        goto found;
+    }
+
+    if(killed(p) || (from != 0 && !ipc_alive(from))){
+      p->ipc_state = IPC_IDLE;
+      release(&ipc_lock);
+      return -1;
+    }
+    p->ipc_peer = from;
+    p->ipc_state = IPC_RECV;
+    sleep(&p->ipc_state, &ipc_lock);
+  }
+
+found:
+  p->ipc_state = IPC_IDLE;
+  len = sp->ipc_len < n ? sp->ipc_len : n;
+  memmove(buf, sp->ipc_msg, len);
+  from = sp->pid;
+
+  // Release the sender.
+  sp->ipc_state = IPC_IDLE;
+  wakeup(&sp->ipc_state);
+  release(&ipc_lock);
+
+  if(copyout(p->pagetable, addr, buf, len) < 0 ||
+     copyout(p->pagetable, fromaddr, (char *)&from, sizeof(from)) < 0)
+    return -1;
+  return len;
+}
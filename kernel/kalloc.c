@@ -26,7 +26,7 @@ struct {
 void
 kinit()
 {
-  initlock(&kmem.lock, "kmem");
+  initlock_kind(&kmem.lock, "kmem", HOTLOCK);
   freerange(end, (void*)PHYSTOP);
 }
 
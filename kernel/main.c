@@ -20,6 +20,14 @@ main()
     kvminit();       // create kernel page table
     kvminithart();   // turn on paging
     procinit();      // process table
+    timerqinit();    // nanosleep() timer queues
+    profinit();      // sampling profiler buffers
+    straceinit();    // system call trace buffer
+    lockbenchinit(); // locks for lockbench()
+    ipcinit();       // send/recv rendezvous
+    pgroupinit();    // process group CPU quotas
+    schedstatinit(); // exit statistics
+    statspageinit(); // read-only scheduler statistics page
     trapinit();      // trap vectors
     trapinithart();  // install kernel trap vector
     plicinit();      // set up interrupt controller
@@ -54,6 +54,9 @@
 //   fixed-size stack
 //   expandable heap
 //   ...
+//   SCHEDSTATS (read-only scheduler statistics, if mapped)
 //   TRAPFRAME (p->trapframe, used by the trampoline)
 //   TRAMPOLINE (the same page as in the kernel)
 #define TRAPFRAME (TRAMPOLINE - PGSIZE)
+#define SCHEDSTATS (TRAPFRAME - PGSIZE)
+#define USERTOP SCHEDSTATS  // the heap may grow up to here
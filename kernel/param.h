@@ -12,4 +12,10 @@
 #define FSSIZE       2000  // size of file system in blocks
 #define MAXPATH      128   // maximum file path name
 #define USERSTACK    1     // user stack pages
+#define IPCMSG       64    // max bytes in a send()/recv() message
+#define NICE_MIN    -20    // highest priority nice value
+#define NICE_MAX     19    // lowest priority nice value
+#define NPGROUP      16    // maximum number of process groups with a CPU quota
+#define CACHELINE    64    // bytes per cache line
+#define NLOCKCLASS   64    // spinlock names tracked by getlockstat()
 
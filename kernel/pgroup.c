@@ -0,0 +1,338 @@
+//
+// CPU bandwidth quotas for process groups.
+//
+// A process group (p->pgid, inherited across fork) can be limited
+// to quota units of CPU time in every period. The scheduler charges
+// each run of a process to its group, and once the group has used
+// its quota it is throttled: none of its processes are dispatched
+// until the period ends.
+//
+
+#include "types.h"
+#include "param.h"
+#include "memlayout.h"
+#include "riscv.h"
+#include "spinlock.h"
+#include "proc.h"
+#include "procinfo.h"
+#include "defs.h"
+
+struct pgroup {
+  struct spinlock lock;   // guards the fields below pgid
+  int pgid;               // fixed once the group is in the table
+  uint64 quota;           // CPU time allowed per period
+  uint64 period;
+  uint64 period_start;    // when the current period began
+  uint64 used;            // CPU time used in the current period
+  int throttled;          // used up quota in the current period?
+  uint64 throttle_start;  // when the group was last throttled
+  uint64 nthrottled;      // periods in which the group hit its quota
+  uint64 throttled_time;  // total time spent throttled
+  int inuse;              // allocated; guarded by pgtable.lock
+};
+
+// The scheduler looks groups up on every dispatch, so lookups
+// take no table lock: they run under rcu_read_lock(), and a
+// removed group is freed only after a grace period (see rcu.c).
+// pgtable.lock serializes changes to the table and to every
+// p->pgid, so that a group found empty stays empty until it is
+// removed; it must be acquired before any p->lock. A group's lock
+// is taken with p->lock held, so it must not be held when
+// acquiring any p->lock.
+struct {
+  struct spinlock lock;
+  struct pgroup *group[NPGROUP];   // from pool[], 0 if free
+  struct pgroup pool[NPGROUP];
+} pgtable;
+
+extern struct proc proc[NPROC];
+
+void
+pgroupinit(void)
+{
+  initlock(&pgtable.lock, "pgtable");
+}
+
+// Allocate a group from the pool, or return 0 if every
+// group is in the table or waiting out a grace period.
+// Caller must hold pgtable.lock.
+static struct pgroup*
+pg_alloc(void)
+{
+  for(struct pgroup *g = pgtable.pool; g < &pgtable.pool[NPGROUP]; g++){
+    if(!g->inuse){
+      memset(g, 0, sizeof(*g));
+      initlock(&g->lock, "pgroup");
+      g->inuse = 1;
+      return g;
+    }
+  }
+  return 0;
+}
+
+// Return g, already removed from the table, to the pool once
+// lookups that may still see it are done. Must not hold any locks.
+static void
+pg_free(struct pgroup *g)
+{
+  synchronize_rcu();
+  acquire(&pgtable.lock);
+  g->inuse = 0;
+  release(&pgtable.lock);
+}
+
+// The table slot of group pgid, or with pgid 0 a free slot,
+// or 0. Caller must be in an RCU read-side section or hold
+// pgtable.lock.
+static struct pgroup**
+pg_slot(int pgid)
+{
+  for(int i = 0; i < NPGROUP; i++){
+    struct pgroup *g = rcu_deref(pgtable.group[i]);
+    if(g ? g->pgid == pgid : pgid == 0)
+      return &pgtable.group[i];
+  }
+  return 0;
+}
+
+// Find the quota'd group pgid, or 0. Caller must be in an
+// RCU read-side section or hold pgtable.lock.
+static struct pgroup*
+pg_find(int pgid)
+{
+  struct pgroup **slot;
+
+  if(pgid <= 0 || (slot = pg_slot(pgid)) == 0)
+    return 0;
+  return rcu_deref(*slot);
+}
+
+// Start a new period if the current one is over, lifting
+// any throttle. Caller must hold g->lock.
+static void
+pg_refresh(struct pgroup *g, uint64 now)
+{
+  if(now - g->period_start < g->period)
+    return;
+  if(g->throttled){
+    g->throttled_time += now - g->throttle_start;
+    g->throttled = 0;
+  }
+  g->period_start = now;
+  g->used = 0;
+}
+
+// Is group pgid over its quota for the current period?
+int
+pg_throttled(int pgid)
+{
+  struct pgroup *g;
+  int throttled = 0;
+
+  if(pgid == 0)
+    return 0;
+
+  rcu_read_lock();
+  if((g = pg_find(pgid)) != 0){
+    acquire(&g->lock);
+    pg_refresh(g, getTime());
+    throttled = g->throttled;
+    release(&g->lock);
+  }
+  rcu_read_unlock();
+  return throttled;
+}
+
+// Charge elapsed CPU time to group pgid, throttling
+// it if that uses up its quota.
+void
+pg_charge(int pgid, uint64 elapsed)
+{
+  struct pgroup *g;
+  uint64 now;
+
+  if(pgid == 0)
+    return;
+
+  rcu_read_lock();
+  if((g = pg_find(pgid)) != 0){
+    acquire(&g->lock);
+    now = getTime();
+    pg_refresh(g, now);
+    g->used += elapsed;
+    if(g->used >= g->quota && !g->throttled){
+      g->throttled = 1;
+      g->throttle_start = now;
+      g->nthrottled++;
+    }
+    release(&g->lock);
+  }
+  rcu_read_unlock();
+}
+
+// Does any process, running or not yet reaped, belong to group
+// pgid? Caller must hold pgtable.lock.
+static int
+pg_members(int pgid)
+{
+  struct proc *p;
+
+  for(p = proc; p < &proc[NPROC]; p++){
+    acquire(&p->lock);
+    if(p->pgid == pgid && p->state != UNUSED){
+      release(&p->lock);
+      return 1;
+    }
+    release(&p->lock);
+  }
+  return 0;
+}
+
+// A process has left group pgid, by being reaped or by moving
+// to another group. Remove the group's quota if that left it
+// empty, so that dead groups do not fill the table.
+// Must not hold any locks.
+void
+pg_leave(int pgid)
+{
+  struct pgroup **slot, *g = 0;
+
+  if(pgid <= 0)
+    return;
+
+  acquire(&pgtable.lock);
+  if((slot = pg_slot(pgid)) != 0 && !pg_members(pgid)){
+    g = *slot;
+    rcu_assign(*slot, 0);
+  }
+  release(&pgtable.lock);
+  if(g)
+    pg_free(g);
+}
+
+// Put np, a new child of p, in p's group.
+void
+pg_fork(struct proc *p, struct proc *np)
+{
+  acquire(&pgtable.lock);
+  acquire(&np->lock);
+  np->pgid = p->pgid;
+  release(&np->lock);
+  release(&pgtable.lock);
+}
+
+// Move process pid (0 means the caller) into process group
+// pgid (0 means a new group named after pid).
+// Returns -1 if there is no such process.
+int
+ksetpgid(int pid, int pgid)
+{
+  struct proc *p;
+  int old = -1;
+
+  if(pid == 0)
+    pid = myproc()->pid;
+  if(pgid == 0)
+    pgid = pid;
+  if(pgid < 0)
+    return -1;
+
+  acquire(&pgtable.lock);
+  for(p = proc; p < &proc[NPROC]; p++){
+    acquire(&p->lock);
+    if(p->pid == pid && p->state != UNUSED){
+      old = p->pgid;
+      p->pgid = pgid;
+      release(&p->lock);
+      break;
+    }
+    release(&p->lock);
+  }
+  release(&pgtable.lock);
+
+  if(old < 0)
+    return -1;
+  if(old != pgid)
+    pg_leave(old);
+  return 0;
+}
+
+// Limit group pgid to quota of CPU time per period.
+// A zero quota or period removes the limit.
+// Returns -1 if pgid is invalid or the table is full.
+int
+ksetquota(int pgid, uint64 quota, uint64 period)
+{
+  struct pgroup **slot, *g;
+
+  if(pgid <= 0)
+    return -1;
+
+  acquire(&pgtable.lock);
+  slot = pg_slot(pgid);
+  if(quota == 0 || period == 0){
+    g = slot ? *slot : 0;
+    if(g)
+      rcu_assign(*slot, 0);
+    release(&pgtable.lock);
+    if(g)
+      pg_free(g);
+    return 0;
+  }
+  if(slot){
+    g = *slot;
+    acquire(&g->lock);
+    g->quota = quota;
+    g->period = period;
+    release(&g->lock);
+  } else {
+    if((slot = pg_slot(0)) == 0 || (g = pg_alloc()) == 0){
+      release(&pgtable.lock);
+      return -1;
+    }
+    g->pgid = pgid;
+    g->quota = quota;
+    g->period = period;
+    g->period_start = getTime();
+    rcu_assign(*slot, g);
+  }
+  release(&pgtable.lock);
+  return 0;
+}
+
+// Copy out the quota and throttling statistics of group pgid
+// to user address addr. Returns -1 if pgid has no quota.
+int
+kgetpgroupinfo(int pgid, uint64 addr)
+{
+  struct pgroup *g;
+  struct pgroupinfo info;
+  uint64 now;
+
+  if(pgid <= 0)
+    return -1;
+
+  rcu_read_lock();
+  if((g = pg_find(pgid)) == 0){
+    rcu_read_unlock();
+    return -1;
+  }
+  acquire(&g->lock);
+  now = getTime();
+  pg_refresh(g, now);
+  info.pgid = g->pgid;
+  info.quota = g->quota;
+  info.period = g->period;
+  info.used = g->used;
+  info.throttled = g->throttled;
+  info.nthrottled = g->nthrottled;
+  info.throttled_time = g->throttled_time;
+  if(g->throttled)
+    info.throttled_time += now - g->throttle_start;
+  release(&g->lock);
+  rcu_read_unlock();
+
+  if(copyout(myproc()->pagetable, addr, (char *)&info, sizeof(info)) < 0)
+    return -1;
+  return 0;
+}
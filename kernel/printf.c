@@ -25,8 +25,25 @@ static struct {
 
 static char digits[] = "0123456789abcdef";
 
+// Where formatted output goes: the console, or the
+// buffer of an snprintf().
+struct out {
+  char *buf;    // 0 for the console
+  int n;        // characters written to buf so far
+  int size;
+};
+
+static void
+outc(struct out *o, int c)
+{
+  if(o->buf == 0)
+    consputc(c);
+  else if(o->n < o->size - 1)
+    o->buf[o->n++] = c;
+}
+
 static void
-printint(long long xx, int base, int sign)
+printint(struct out *o, long long xx, int base, int sign)
 {
   char buf[20];
   int i;
@@ -46,34 +63,28 @@ printint(long long xx, int base, int sign)
     buf[i++] = '-';
 
   while(--i >= 0)
-    consputc(buf[i]);
+    outc(o, buf[i]);
 }
 
 static void
-printptr(uint64 x)
+printptr(struct out *o, uint64 x)
 {
   int i;
-  consputc('0');
-  consputc('x');
+  outc(o, '0');
+  outc(o, 'x');
   for (i = 0; i < (sizeof(uint64) * 2); i++, x <<= 4)
-    consputc(digits[x >> (sizeof(uint64) * 8 - 4)]);
+    outc(o, digits[x >> (sizeof(uint64) * 8 - 4)]);
 }
 
-// Print to the console.
-int
-printf(char *fmt, ...)
+static void
+vprintf(struct out *o, char *fmt, va_list ap)
 {
-  va_list ap;
   int i, cx, c0, c1, c2;
   char *s;
 
-  if(panicking == 0)
-    acquire(&pr.lock);
-
-  va_start(ap, fmt);
   for(i = 0; (cx = fmt[i] & 0xff) != 0; i++){
     if(cx != '%'){
-      consputc(cx);
+      outc(o, cx);
       continue;
     }
     i++;
@@ -82,49 +93,62 @@ printf(char *fmt, ...)
     if(c0) c1 = fmt[i+1] & 0xff;
     if(c1) c2 = fmt[i+2] & 0xff;
     if(c0 == 'd'){
-      printint(va_arg(ap, int), 10, 1);
+      printint(o, va_arg(ap, int), 10, 1);
     } else if(c0 == 'l' && c1 == 'd'){
-      printint(va_arg(ap, uint64), 10, 1);
+      printint(o, va_arg(ap, uint64), 10, 1);
       i += 1;
     } else if(c0 == 'l' && c1 == 'l' && c2 == 'd'){
-      printint(va_arg(ap, uint64), 10, 1);
+      printint(o, va_arg(ap, uint64), 10, 1);
       i += 2;
     } else if(c0 == 'u'){
-      printint(va_arg(ap, uint32), 10, 0);
+      printint(o, va_arg(ap, uint32), 10, 0);
     } else if(c0 == 'l' && c1 == 'u'){
-      printint(va_arg(ap, uint64), 10, 0);
+      printint(o, va_arg(ap, uint64), 10, 0);
       i += 1;
     } else if(c0 == 'l' && c1 == 'l' && c2 == 'u'){
-      printint(va_arg(ap, uint64), 10, 0);
+      printint(o, va_arg(ap, uint64), 10, 0);
       i += 2;
     } else if(c0 == 'x'){
-      printint(va_arg(ap, uint32), 16, 0);
+      printint(o, va_arg(ap, uint32), 16, 0);
     } else if(c0 == 'l' && c1 == 'x'){
-      printint(va_arg(ap, uint64), 16, 0);
+      printint(o, va_arg(ap, uint64), 16, 0);
       i += 1;
     } else if(c0 == 'l' && c1 == 'l' && c2 == 'x'){
-      printint(va_arg(ap, uint64), 16, 0);
+      printint(o, va_arg(ap, uint64), 16, 0);
       i += 2;
     } else if(c0 == 'p'){
-      printptr(va_arg(ap, uint64));
+      printptr(o, va_arg(ap, uint64));
     } else if(c0 == 'c'){
-      consputc(va_arg(ap, uint));
+      outc(o, va_arg(ap, uint));
     } else if(c0 == 's'){
       if((s = va_arg(ap, char*)) == 0)
         s = "(null)";
       for(; *s; s++)
-        consputc(*s);
+        outc(o, *s);
     } else if(c0 == '%'){
-      consputc('%');
+      outc(o, '%');
     } else if(c0 == 0){
       break;
     } else {
       // Print unknown % sequence to draw attention.
-      consputc('%');
-      consputc(c0);
+      outc(o, '%');
+      outc(o, c0);
     }
-
   }
+}
+
+// Print to the console.
+int
+printf(char *fmt, ...)
+{
+  va_list ap;
+  struct out o = { 0, 0, 0 };
+
+  if(panicking == 0)
+    acquire(&pr.lock);
+
+  va_start(ap, fmt);
+  vprintf(&o, fmt, ap);
   va_end(ap);
 
   if(panicking == 0)
@@ -133,6 +157,23 @@ printf(char *fmt, ...)
   return 0;
 }
 
+// Format into buf, which holds size bytes, truncating if
+// need be. Returns the length of the (NUL-terminated) result.
+int
+snprintf(char *buf, int size, char *fmt, ...)
+{
+  va_list ap;
+  struct out o = { buf, 0, size };
+
+  if(size <= 0)
+    return 0;
+  va_start(ap, fmt);
+  vprintf(&o, fmt, ap);
+  va_end(ap);
+  buf[o.n] = 0;
+  return o.n;
+}
+
 void
 panic(char *s)
 {
@@ -4,6 +4,9 @@
 #include "riscv.h"
 #include "spinlock.h"
 #include "proc.h"
+#include "schedctl.h"
+#include "procinfo.h"
+#include "schedpolicy.h"
 #include "defs.h"
 
 struct cpu cpus[NCPU];
@@ -19,6 +22,7 @@ enum sched_policy SCHED_POLICY = SCHEDPOLICY;
 
 extern uint ticks;
 extern struct spinlock tickslock;
+extern struct spinlock ipc_lock;
 
 int nextpid = 1;
 struct spinlock pid_lock;
@@ -26,7 +30,56 @@ struct spinlock pid_lock;
 extern void forkret(void);
 static void freeproc(struct proc *p);
 
-static const uint64 quantum[3] = {0.5*10000, 1*10000, 2*10000};  //Quantum in milleseconds
+// The policy decisions themselves (keys, quanta, levels) are
+// in schedpolicy.c, shared with the host simulator.
+
+// p's MLFQ quantum at its current level and nice value.
+static uint64
+proc_quantum(struct proc *p)
+{
+  return mlfq_quantum(p->queue_level, p->priority);
+}
+
+// Interactivity score (0-100) a process needs for MLFQ to boost
+// it when it wakes from console or disk I/O. Set by schedctl().
+int interact_thresh = INTERACT_THRESH;
+
+// Share of p's recent history spent sleeping rather than running,
+// 0-100. High for shells and editors, low for CPU hogs.
+int
+interactivity(struct proc *p)
+{
+  return interact_score(p->sleep_recent, p->run_recent);
+}
+
+static void
+interact_decay(struct proc *p)
+{
+  interact_decay_hist(&p->sleep_recent, &p->run_recent);
+}
+
+// How long a process may wait RUNNABLE before the starvation
+// watchdog flags it (1 s of a 10MHz clock), and whether SJF/STCF
+// then age it to the front of the queue. Set by schedctl().
+uint64 starve_thresh = 1000*10000;
+int sjf_aging = 0;
+
+// Mark p RUNNABLE, starting the clock on its run-queue wait.
+// Caller must hold p->lock.
+static void
+setrunnable(struct proc *p)
+{
+  p->state = RUNNABLE;
+  p->rstart = getTime();
+}
+
+// Has RUNNABLE process p waited long enough for SJF/STCF
+// to age it past jobs with shorter hints?
+static int
+aged(struct proc *p, uint64 now)
+{
+  return sjf_aging && now - p->rstart > starve_thresh;
+}
 
 extern char trampoline[]; // trampoline.S
 
@@ -166,12 +219,41 @@ found:
   p->rtime = 0;
   p->stime = 0;
   p->ltime = 0;
+  p->utime = 0;
+  p->ktime = 0;
+  p->wtime = 0;
+  p->acct_stamp = 0;
+  p->uinstret = 0;
+  p->ucycles = 0;
+  p->nvcsw = 0;
+  p->nivcsw = 0;
+  p->lastcpu = -1;
+  p->nmigrate = 0;
+  p->npromote = 0;
+  p->ndemote = 0;
+  p->nboost = 0;
   p->expected_runtime = 0;
   p->time_left = 0;
   p->priority = 0;
+  p->slice_ticks = 0;
+  p->rr_skip = 0;
+  p->slptime = 0;
+  p->sleep_start = 0;
+  p->iowait = 0;
+  p->sleep_recent = 0;
+  p->run_recent = 0;
+  p->rstart = 0;
+  p->starving = 0;
+  p->nstarved = 0;
+  memset(&p->waithist, 0, sizeof(p->waithist));
+  memset(&p->wakehist, 0, sizeof(p->wakehist));
+  memset(p->sysn, 0, sizeof(p->sysn));
+  memset(p->systime, 0, sizeof(p->systime));
+  p->wakestamp = 0;
   p->queue_level = 0;
-  p->time_slice = quantum[0];
-  p->demote = 0;
+  p->time_slice = mlfq_quantum(0, 0);
+  p->donate_to = 0;
+  p->pgid = 0;
 
   return p;
 }
@@ -206,7 +288,7 @@ freeproc(struct proc *p)
   p->priority = 0;
   p->queue_level = 0;
   p->time_slice = 0;
-  p->demote = 0;
+  p->donate_to = 0;
 
   p->state = UNUSED;
 }
@@ -253,6 +335,8 @@ void proc_freepagetable(pagetable_t pagetable, uint64 sz)
 {
   uvmunmap(pagetable, TRAMPOLINE, 1, 0);
   uvmunmap(pagetable, TRAPFRAME, 1, 0);
+  if (statsmapped(pagetable))
+    uvmunmap(pagetable, SCHEDSTATS, 1, 0);
   uvmfree(pagetable, sz);
 }
 
@@ -266,7 +350,7 @@ void userinit(void)
 
   p->cwd = namei("/");
 
-  p->state = RUNNABLE;
+  setrunnable(p);
 
   uint64 time = getTime();
   p->ctime = time;
@@ -284,7 +368,7 @@ int growproc(int n)
   sz = p->sz;
   if (n > 0)
   {
-    if (sz + n > TRAPFRAME)
+    if (sz + n > USERTOP)
     {
       return -1;
     }
@@ -324,6 +408,14 @@ int kfork(void)
   }
   np->sz = p->sz;
 
+  // The child shares the statistics page if the parent mapped it.
+  if (statsmapped(p->pagetable) && mapstats(np->pagetable) < 0)
+  {
+    freeproc(np);
+    release(&np->lock);
+    return -1;
+  }
+
   // copy saved user registers.
   *(np->trapframe) = *(p->trapframe);
 
@@ -339,16 +431,23 @@ int kfork(void)
   safestrcpy(np->name, p->name, sizeof(p->name));
 
   np->expected_runtime = p->expected_runtime;
+
+  // inherit the nice value, and start in the MLFQ level it maps to.
+  np->priority = p->priority;
+  np->queue_level = mlfq_level(np->priority);
+  np->time_slice = proc_quantum(np);
   pid = np->pid;
 
   release(&np->lock);
 
+  pg_fork(p, np);
+
   acquire(&wait_lock);
   np->parent = p;
   release(&wait_lock);
 
   acquire(&np->lock);
-  np->state = RUNNABLE;
+  setrunnable(np);
   release(&np->lock);
 
   return pid;
@@ -396,6 +495,11 @@ void kexit(int status)
   end_op();
   p->cwd = 0;
 
+  // Peers blocked in send()/recv() with us must not run their
+  // liveness check until we are a ZOMBIE.
+  acquire(&ipc_lock);
+  ipc_exit(p);
+
   acquire(&wait_lock);
 
   // Give any children to init.
@@ -406,29 +510,13 @@ void kexit(int status)
 
   acquire(&p->lock);
 
-  uint64 time = getTime();
-  uint64 elapsed = getTime() - p->ltime;
-  
-  // Account for elapsed time
-  if (elapsed < p->time_slice) {
-    p->time_slice -= elapsed;
-  } else{
-    p->time_slice = 0;
-    p->demote = 1;
-  }
-
+  // run() charges this last run and sets etime once
+  // sched() returns to the scheduler.
   p->xstate = status;
-  p->rtime += elapsed;  //cpu burst time tracking
-  if (p->time_left > 0){
-    p->time_left -= elapsed;
-  }
-  if (p->time_left < 0){
-    p->time_left = 0;
-  }
-  p->etime = time;
   p->state = ZOMBIE;
 
   release(&wait_lock);
+  release(&ipc_lock);
 
   // Jump into the scheduler, never to return.
   sched();
@@ -436,12 +524,15 @@ void kexit(int status)
 }
 
 // Wait for a child process to exit and return its pid.
+// If infoaddr is not 0, also copy out the child's final
+// procinfo, taken as it is reaped.
 // Return -1 if this process has no children.
-int kwait(uint64 addr)
+int kwait(uint64 addr, uint64 infoaddr)
 {
   struct proc *pp;
-  int havekids, pid;
+  int havekids, pid, pgid;
   struct proc *p = myproc();
+  struct procinfo info;
 
   acquire(&wait_lock);
 
@@ -461,16 +552,22 @@ int kwait(uint64 addr)
         {
           // Found one.
           pid = pp->pid;
-          if (addr != 0 && copyout(p->pagetable, addr, (char *)&pp->xstate,
-                                   sizeof(pp->xstate)) < 0)
+          if (infoaddr != 0)
+            fillprocinfo(pp, &info);
+          if ((addr != 0 && copyout(p->pagetable, addr, (char *)&pp->xstate,
+                                    sizeof(pp->xstate)) < 0) ||
+              (infoaddr != 0 && copyout(p->pagetable, infoaddr, (char *)&info,
+                                        sizeof(info)) < 0))
           {
             release(&pp->lock);
             release(&wait_lock);
             return -1;
           }
+          pgid = pp->pgid;
           freeproc(pp);
           release(&pp->lock);
           release(&wait_lock);
+          pg_leave(pgid);
           return pid;
         }
         release(&pp->lock);
@@ -489,226 +586,211 @@ int kwait(uint64 addr)
   }
 }
 
-// Scheduling policies ----------------------
-
-// default, round robin
-static int
-schedule_rr(struct cpu *c)
+// Snapshot p's scheduling metadata into *info.
+// Caller must hold p->lock.
+void
+fillprocinfo(struct proc *p, struct procinfo *info)
 {
-  struct proc *p;
-  int found = 0;
-  for (p = proc; p < &proc[NPROC]; p++)
-  {
-    acquire(&p->lock);
-
-    if (p->state == RUNNABLE)
-    {
-      p->state = RUNNING;
-      p -> ltime = getTime();
-      if (p->rtime == 0){
-        p->stime = getTime();
-      }
-      c->proc = p;
+  info->pid = p->pid;
+  info->state = p->state;
+  info->ctime = p->ctime;
+  info->etime = p->etime;
+  info->rtime = p->rtime;
+  info->stime = p->stime;
+
+  info->expected_runtime = p->expected_runtime;
+  info->time_left = p->time_left;
+  info->priority = p->priority;
+  info->queue_level = p->queue_level;
+  info->time_slice = p->time_slice;
+  info->utime = p->utime;
+  info->instret = p->uinstret;
+  info->cycles = p->ucycles;
+  info->ktime = p->ktime;
+  info->wtime = p->wtime;
+  info->slptime = p->slptime;
+  info->nvcsw = p->nvcsw;
+  info->nivcsw = p->nivcsw;
+  info->nmigrate = p->nmigrate;
+  info->npromote = p->npromote;
+  info->ndemote = p->ndemote;
+  info->nboost = p->nboost;
+  info->interactivity = interactivity(p);
+  info->pgid = p->pgid;
+  info->nstarved = p->nstarved;
+  info->maxwait = p->waithist.max;
+  safestrcpy(info->name, p->name, sizeof(info->name));
+}
 
-      // printf("RR: running PID %d\n", p->pid);
-      swtch(&c->context, &p->context);
-      p->rtime += getTime() - p->ltime;
+// CPU time accounting ----------------------
+//
+// A running process's time is cut into stretches at every trap
+// from user space, every return to user space, and every switch
+// away from it in run(). acct_stamp marks the start of the
+// current stretch; each cut charges it to utime or ktime.
+// The hart's instret and cycle counters are charged the same
+// way for user stretches, which start and end on one hart.
+
+// Trap entry from user space: the stretch that just ended
+// was user time.
+void
+acct_trapenter(struct proc *p)
+{
+  uint64 now = getTime();
 
-      c->proc = 0;
-      found = 1;
-    }
-    release(&p->lock);
-  }
-  return found;
+  p->utime += now - p->acct_stamp;
+  p->acct_stamp = now;
+  p->uinstret += getInstret() - p->instret_stamp;
+  p->ucycles += getCycles() - p->cycle_stamp;
 }
 
-// FIFO
-static int
-schedule_fifo(struct cpu *c)
+// About to return to user space: the stretch that just
+// ended was kernel time. If p was woken since it last left
+// user space, record how late it gets back there.
+// Interrupts are off.
+void
+acct_trapexit(struct proc *p)
 {
-    struct proc *p;
-    struct proc *selected = 0;  // process with earliest ctime
-    int found = 0;
+  uint64 now = getTime();
 
-    // First pass: find the RUNNABLE process with the smallest ctime
-    for(p = proc; p < &proc[NPROC]; p++) {
-        if(p->state == RUNNABLE) {
-            if (!selected || p->ctime < selected->ctime) {
-                selected = p;
-            }
-        }
-    }
+  p->ktime += now - p->acct_stamp;
+  p->acct_stamp = now;
+  p->instret_stamp = getInstret();
+  p->cycle_stamp = getCycles();
 
-    // If a process is found, acquire its lock and run it
-    if (selected) {
-        acquire(&selected->lock);
-
-        // Make sure it's still runnable 
-        if(selected->state == RUNNABLE) {
-            selected->state = RUNNING;
-            selected -> ltime = getTime();
-            if (selected->rtime == 0){
-              selected->stime = getTime();
-            }
-            c->proc = selected;
-
-            swtch(&c->context, &selected->context);
-            selected->rtime += getTime() - selected->ltime;
-            c->proc = 0;
-            found = 1;
-        }
+  // only wakeproc() sets wakestamp, and not while p runs, so
+  // the lock is needed just when there is a wakeup to record.
+  if (p->wakestamp)
+  {
+    acquire(&p->lock);
+    hist_add(&p->wakehist, now - p->wakestamp);
+    hist_add(&mycpu()->wakehist, now - p->wakestamp);
+    p->wakestamp = 0;
+    release(&p->lock);
+  }
+}
 
-        release(&selected->lock);
-    }
+// Scheduling policies ----------------------
 
-    return found;
+// A peek at p->state without p->lock, so that scans pass over
+// processes that are not RUNNABLE without locking each one.
+// The answer may be stale: callers recheck under p->lock.
+static inline int
+maybe_runnable(struct proc *p)
+{
+  return __atomic_load_n(&p->state, __ATOMIC_RELAXED) == RUNNABLE;
 }
 
-// Shortest job first
+// Can p be picked to run now? It must be RUNNABLE, and its
+// process group must not be over its CPU quota.
+// Caller must hold p->lock.
 static int
-schedule_sjf(struct cpu *c)
+dispatchable(struct proc *p)
 {
-  struct proc *best = 0;
-  uint64 best_key = ~0ULL;
-  uint64 best_ctime = ~0ULL;
-  int best_pid = 0;
+  return p->state == RUNNABLE && !pg_throttled(p->pgid);
+}
 
-  for (struct proc *p = proc; p < &proc[NPROC]; p++) {
-    acquire(&p->lock);
-    if (p->state == RUNNABLE) {
-      // 0 hint means "no info" -> treat as very large.
-      uint64 key = p->expected_runtime ? p->expected_runtime : ~0ULL;
-
-      if (best == 0 ||
-        key < best_key ||
-        (key == best_key && (p->ctime < best_ctime ||
-        (p->ctime == best_ctime && p->pid < best_pid)))
-      ) {
-        best = p;
-        best_key = key;
-        best_ctime = p->ctime;
-        best_pid = p->pid;
-      }
-    }
-    release(&p->lock);
-  }
+// Switch to p and run it until it gives the CPU back.
+// Caller must hold p->lock and have checked dispatchable(p).
+// Returns how long p ran.
+static uint64
+run(struct cpu *c, struct proc *p)
+{
+  uint64 now, elapsed, cycles;
 
-  if (best == 0)
-    return 0;
-  // If *all* RUNNABLE candidates had no hint, run RR this round.
-  if (best_key == ~0ULL)
-    return schedule_rr(c);
-
-  acquire(&best->lock);
-  if (best->state != RUNNABLE) {
-    // Raced with another CPU; try again.
-    release(&best->lock);
-    return 0;
-  }
+  p->state = RUNNING;
+  p->slice_ticks = 0;
+  p->ltime = getTime();
+  p->acct_stamp = p->ltime;
 
-  best->state = RUNNING;
-  if (best->rtime == 0){
-      best->stime = getTime();
-  }
-  c->proc = best;
+  // record how long p waited in the run queue.
+  p->wtime += p->ltime - p->rstart;
+  hist_add(&p->waithist, p->ltime - p->rstart);
+  hist_add(&c->waithist, p->ltime - p->rstart);
+  p->starving = 0;
 
-  // printf("SJF: running PID %d\n", best->pid);
-  best->ltime = getTime();
-  swtch(&c->context, &best->context);
-  best->rtime += getTime() - best->ltime;
+  if (p->stime == 0){
+    p->stime = p->ltime;
+  }
+  if (p->lastcpu >= 0 && p->lastcpu != c - cpus)
+    p->nmigrate++;
+  p->lastcpu = c - cpus;
+  c->proc = p;
+
+  // this decision took from the end of the last run (or wfi)
+  // to here. swtch() comes back on this CPU, so its cycle
+  // counter can time the run even if p later runs elsewhere.
+  cycles = getCycles();
+  c->stats.sched += cycles - c->pickstart;
+  hist_add(&c->stats.decide, cycles - c->pickstart);
+  swtch(&c->context, &p->context);
+  c->pickstart = getCycles();
+  c->stats.busy += c->pickstart - cycles;
+
+  // p always gives up the CPU from inside the kernel.
+  now = getTime();
+  p->ktime += now - p->acct_stamp;
+  elapsed = now - p->ltime;
+  p->rtime += elapsed;
+  c->stats.nswitch++;
+  if (p->state == ZOMBIE)
+  {
+    p->etime = now;
+    exitstat_add(p);
+  }
+  p->run_recent += elapsed;
+  interact_decay(p);
+  pg_charge(p->pgid, elapsed);
+  if (p->time_left > elapsed){
+    p->time_left -= elapsed;
+  } else {
+    p->time_left = 0;
+  }
 
   c->proc = 0;
-  release(&best->lock);
-  return 1;
+  return elapsed;
 }
 
-// Shortest time to completion first
+static void mlfq_charge(struct proc *p, uint64 elapsed);
+
+// Run the process that the previous one on this CPU yielded to
+// with yield_to() or send(), bypassing the policy. The donor's
+// remaining time slice goes with it.
 static int
-schedule_stcf(struct cpu *c)
+schedule_handoff(struct cpu *c)
 {
-  struct proc *best = 0;
-  uint64 best_key = ~0ULL;
-  uint64 best_ctime = ~0ULL;
-  int best_pid = 0;
+  struct proc *p;
+  int pid = c->handoff;
+  uint64 slice = c->handoff_slice;
 
-  for (struct proc *p = proc; p < &proc[NPROC]; p++)
+  c->handoff = 0;
+  for (p = proc; p < &proc[NPROC]; p++)
   {
+    if (!maybe_runnable(p))
+      continue;
     acquire(&p->lock);
-    if (p->state == RUNNABLE)
+    if (p->pid == pid && dispatchable(p))
     {
-      uint64 key;
-      if (p->expected_runtime == 0)
-      {
-        key = ~0ULL;
-      }
-      else
-      {
-        key = p->time_left;
-      }
-
-      // if (best != 0)
-      // {
-      //   printf("STCF pick: pid=%d time_left=%lu key=%lu\n",
-      //          best->pid,
-      //          (unsigned long)best->time_left,
-      //          (unsigned long)best_key);
-      // }
-
-      if (best == 0 ||
-          key < best_key ||
-          (key == best_key && (p->ctime < best_ctime ||
-                               (p->ctime == best_ctime && p->pid < best_pid))))
-      {
-        best = p;
-        best_key = key;
-        best_ctime = p->ctime;
-        best_pid = p->pid;
-      }
+      if (p->time_slice < slice)
+        p->time_slice = slice;
+      uint64 elapsed = run(c, p);
+      if (SCHED_POLICY == MLFQ)
+        mlfq_charge(p, elapsed);
+      release(&p->lock);
+      return 1;
     }
     release(&p->lock);
   }
-
-  if (best == 0)
-    return 0;
-  if (best_key == ~0ULL)
-    return schedule_rr(c);
-
-  acquire(&best->lock);
-  if (best->state != RUNNABLE)
-  {
-    release(&best->lock);
-    return 1;
-  }
-
-  best->state = RUNNING;
-  if (best->rtime == 0){
-      best->stime = getTime();
-  }
-  c->proc = best;
-
-  best->ltime = getTime();
-  swtch(&c->context, &best->context);
-  best->rtime += getTime() - best->ltime;
-  if (best->time_left > 0){
-    best->time_left -= getTime() - best->ltime;
-  }
-  if (best->time_left < 0){
-    best->time_left = 0;
-  }
-
-  c->proc = 0;
-  release(&best->lock);
-  return 1;
+  return 0;
 }
 
-
 //struct proc proc_prty1[NPROC];
 //struct proc proc_prty2[NPROC];
 //struct proc proc_prty3[NPROC];
 
 //int prty_arr[3] = {1,2,4};
 
-uint64 starv_cut = 1000*10000;
+uint64 starv_cut = MLFQ_STARVE_CUT;
 
 void
 starvation_clean(void)
@@ -718,108 +800,87 @@ starvation_clean(void)
 
   // --- 1. Aging Step (prevent starvation)
   for (p = proc; p < &proc[NPROC]; p++) {
+    if (!maybe_runnable(p))
+      continue;
     acquire(&p->lock);
-    if (p->state == RUNNABLE) {
-      uint64 waited = time - p->etime;
-      if (waited > starv_cut && p->queue_level > 0) { // waited > 200ms
-        p->queue_level--;
-        p->time_slice = quantum[p->queue_level];
-      }
+    if (p->state == RUNNABLE &&
+        mlfq_age(&p->queue_level, &p->time_slice, p->priority, time - p->etime, starv_cut)) {
+      p->nboost++;
     }
     release(&p->lock);
   }
 }
 
 
-//Get time for 
-int startIndex[3] = {0,0,0};
-// Multi level feedback queue
-static int
-schedule_mlfq(struct cpu *c)
+// Charge elapsed running time against p's MLFQ time slice,
+// demoting p a level once the slice is used up.
+static void
+mlfq_charge(struct proc *p, uint64 elapsed)
 {
-  struct proc *p;
-  struct proc *min_p;
-
-  int found = 0;
-
-  start_search:
-  starvation_clean();
-
-  for (int prty = 0; prty < 3; prty ++) {
-    min_p = 0;
+  p->etime = getTime();
+  if (mlfq_charge_slice(&p->queue_level, &p->time_slice, p->priority, elapsed))
+    p->ndemote++;
+}
 
-    for(p = proc; p < &proc[NPROC]; p++) {
+// The pick loops themselves (RR passes, FIFO, SJF/STCF and MLFQ)
+// are in schedpolicy.c, shared with the simulator. They reach
+// proc[] through these; arg is this CPU.
 
-      acquire(&p->lock);
-      if(p -> queue_level == prty && p->state == RUNNABLE) {
-        if (min_p == 0 || p->ltime < min_p->ltime) { //find last scheduled job
-          if (min_p != 0) { 
-            c -> intena = 0;
-            release(&min_p -> lock);
-          }
-          min_p = p;
-          continue;
-        }
-      }
-      c -> intena = 0;
-      release(&p -> lock);
-    }
-    if (min_p != 0) {
-      //lock for min_p already acquired
-      p = min_p;
-      //printf("pid %d \n", p -> pid);
-
-      if (p->state != RUNNABLE) {
-        break;
-      }
-      p->state = RUNNING;
-      c->proc = p;
+// Lock proc[i] and keep it locked if it is dispatchable.
+static int
+sched_get(void *arg, int i, struct sched_cand *cand)
+{
+  struct proc *p = &proc[i];
 
-      p -> ltime = getTime();
+  if (!maybe_runnable(p))
+    return 0;
+  acquire(&p->lock);
+  if (!dispatchable(p)) {
+    release(&p->lock);
+    return 0;
+  }
+  cand->nice = p->priority;
+  cand->pid = p->pid;
+  cand->ctime = p->ctime;
+  cand->expected = p->expected_runtime;
+  cand->time_left = p->time_left;
+  cand->aged = aged(p, getTime());
+  cand->level = p->queue_level;
+  cand->ltime = p->ltime;
+  cand->rr_skip = &p->rr_skip;
+  return 1;
+}
 
-      //check if first schedule
-      if (p -> stime == 0) {
-        p -> stime = p -> ltime;
-      }
+static void
+sched_put(void *arg, int i)
+{
+  release(&proc[i].lock);
+}
 
-      swtch(&c->context, &p->context);
-      p->rtime += getTime() - p->ltime;
+static void
+sched_run(void *arg, int i)
+{
+  uint64 elapsed = run((struct cpu *)arg, &proc[i]);
 
-      uint64 time = getTime();
-      uint64 elapsed = time - p->ltime;
-      p->etime = time;
+  if (SCHED_POLICY == MLFQ)
+    mlfq_charge(&proc[i], elapsed);
+}
 
-      // Account for elapsed time
-      if (elapsed < p->time_slice) {
-        p->time_slice -= elapsed;
-      } else {
-        p->time_slice = 0;
-        p->demote = 1;
-      }
-      p->rtime += elapsed;
+// RR and MLFQ run several processes per scheduler() round,
+// so they honor yield_to()/send() handoffs between picks too.
+static int
+sched_handoff(void *arg)
+{
+  struct cpu *c = arg;
 
-      if (p -> time_slice == 0 && p -> queue_level < 2) {
-        if (p -> priority < 2) {
-            p -> priority++;
-        }
-        // printf("Demotion happened for process %d with queue_level %d \n", p -> pid, p->queue_level);
-        p -> queue_level++;
-        p -> time_slice = quantum[p -> priority];
-        p -> demote = 0;
-      } 
-
-      c->proc = 0;
-      found = 1;
-      c->intena = 0;
-      release(&p->lock);
-      goto start_search;
-    }
-    c->intena = 0;
-  } 
-  
-  return found;
+  return c->handoff && schedule_handoff(c);
 }
 
+static void
+sched_age(void *arg)
+{
+  starvation_clean();
+}
 
 // Per-CPU process scheduler.
 // Each CPU calls scheduler() after setting itself up.
@@ -831,8 +892,12 @@ schedule_mlfq(struct cpu *c)
 void scheduler(void)
 {
   struct cpu *c = mycpu();
+  struct sched_ops ops = {
+    NPROC, sched_get, sched_put, sched_run, sched_handoff, sched_age, c
+  };
 
   c->proc = 0;
+  c->pickstart = getCycles();
   for (;;)
   {
     // The most recent process to run may have had interrupts
@@ -842,42 +907,60 @@ void scheduler(void)
     // and wfi.
     intr_on();
     intr_off();
+    rcu_qs();
 
     int found = 0;
 
-    switch (SCHED_POLICY)
+    // A process that gave its CPU to a specific pid with
+    // yield_to() or send() has that pid run next, whatever
+    // the policy would pick.
+    if (c->handoff)
+      found = schedule_handoff(c);
+
+    if (!found)
     {
-      case FIFO:
-      {
-        found = schedule_fifo(c);
-        break;
-      }
-      case SJF:
-      {
-        found = schedule_sjf(c);
-        break;
-      }
-      case STCF:
-      {
-        found = schedule_stcf(c);
-        break;
-      }
-      case MLFQ:
+      switch (SCHED_POLICY)
       {
-        found = schedule_mlfq(c);
-        break;
-      }
-      default:
-      {
-        found = schedule_rr(c);
-        break;
+        case FIFO:
+        {
+          found = sched_fifo(&ops);
+          break;
+        }
+        case SJF:
+        {
+          found = sched_shortest(&ops, 0);
+          break;
+        }
+        case STCF:
+        {
+          found = sched_shortest(&ops, 1);
+          break;
+        }
+        case MLFQ:
+        {
+          found = sched_mlfq(&ops);
+          break;
+        }
+        default:
+        {
+          found = sched_rr(&ops);
+          break;
+        }
       }
     }
 
     if (found == 0)
     {
-      // nothing to run; stop running on this core until an interrupt.
+      // a search that found nothing is scheduling time too,
+      // but not a decision. then stop running on this core
+      // until an interrupt.
+      uint64 now = getCycles();
+      c->stats.sched += now - c->pickstart;
+      rcu_idle(1);
       asm volatile("wfi");
+      rcu_idle(0);
+      c->pickstart = getCycles();
+      c->stats.idle += c->pickstart - now;
     }
   }
 }
@@ -903,6 +986,12 @@ void sched(void)
   if (intr_get())
     panic("sched interruptible");
 
+  if (p->donate_to){
+    mycpu()->handoff = p->donate_to;
+    mycpu()->handoff_slice = p->time_slice;
+    p->donate_to = 0;
+  }
+
   intena = mycpu()->intena;
   swtch(&p->context, &mycpu()->context);
 
@@ -915,9 +1004,62 @@ void yield(void)
   struct proc *p = myproc();
   acquire(&p->lock);
   
-  p->state = RUNNABLE;
+  p->nvcsw++;
+  setrunnable(p);
+  sched();
+  release(&p->lock);
+}
+
+// Like yield(), but forced on the process by a timer
+// interrupt because its time slice is up.
+void preempt(void)
+{
+  struct proc *p = myproc();
+  acquire(&p->lock);
+
+  p->nivcsw++;
+  setrunnable(p);
+  sched();
+  release(&p->lock);
+}
+
+// Called on each timer interrupt taken while p runs in user space.
+// Returns 1 if p has used up its time and should yield.
+int
+timeslice_up(struct proc *p)
+{
+  if (SCHED_POLICY != RR)
+    return 1;
+  return ++p->slice_ticks >= rr_ticks(p->priority);
+}
+
+// Give up the CPU to the process with the given pid, which runs
+// next on this CPU if it is RUNNABLE, with the rest of our slice.
+// Returns -1 if there is no such process.
+int
+kyield_to(int pid)
+{
+  struct proc *p = myproc();
+  struct proc *q;
+
+  if (pid <= 0 || pid == p->pid || (q = getproc(pid)) == 0)
+    return -1;
+  acquire(&q->lock);
+  if (q->pid != pid)
+  {
+    // exited and reused since getproc() found it.
+    release(&q->lock);
+    return -1;
+  }
+  release(&q->lock);
+
+  acquire(&p->lock);
+  p->donate_to = pid;
+  p->nvcsw++;
+  setrunnable(p);
   sched();
   release(&p->lock);
+  return 0;
 }
 
 // A fork child's very first scheduling by scheduler()
@@ -959,8 +1101,10 @@ void forkret(void)
 }
 
 // Sleep on channel chan, releasing condition lock lk.
-// Re-acquires lk when awakened.
-void sleep(void *chan, struct spinlock *lk)
+// Re-acquires lk when awakened. io says whether this is
+// a wait for a device (see sleepio()).
+static void
+sleep1(void *chan, struct spinlock *lk, int io)
 {
   struct proc *p = myproc();
 
@@ -976,18 +1120,65 @@ void sleep(void *chan, struct spinlock *lk)
  
   // Go to sleep.
   p->chan = chan;
+  p->iowait = io;
+  p->sleep_start = getTime();
+  p->nvcsw++;
   p->state = SLEEPING;
 
   sched();
 
   // Tidy up.
   p->chan = 0;
+  p->iowait = 0;
 
   // Reacquire original lock.
   release(&p->lock);
   acquire(lk);
 }
 
+void sleep(void *chan, struct spinlock *lk)
+{
+  sleep1(chan, lk, 0);
+}
+
+// Like sleep(), but for a process waiting on console input or
+// the disk. MLFQ keeps interactive processes woken from such a
+// sleep at a high level (see wakeproc()).
+void sleepio(void *chan, struct spinlock *lk)
+{
+  sleep1(chan, lk, 1);
+}
+
+// Make sleeping process p RUNNABLE, crediting it with the
+// time it slept. Caller must hold p->lock.
+static void
+wakeproc(struct proc *p)
+{
+  uint64 slept = getTime() - p->sleep_start;
+
+  p->slptime += slept;
+  p->sleep_recent += slept;
+  interact_decay(p);
+
+  // I/O boost for an interactive process that waited on a device.
+  if (SCHED_POLICY == MLFQ && p->iowait &&
+      mlfq_wake_boost(&p->queue_level, &p->time_slice, p->priority,
+                      interactivity(p), interact_thresh)) {
+    p->npromote++;
+  }
+
+  setrunnable(p);
+  p->wakestamp = p->rstart;
+}
+
+// Wake p if it is sleeping on chan: wakeup() for a process
+// known in advance. Caller must hold p->lock.
+void wakeupproc(struct proc *p, void *chan)
+{
+  if (p->state == SLEEPING && p->chan == chan)
+    wakeproc(p);
+}
+
 // Wake up all processes sleeping on channel chan.
 // Caller should hold the condition lock.
 void wakeup(void *chan)
@@ -1001,13 +1192,227 @@ void wakeup(void *chan)
       acquire(&p->lock);
       if (p->state == SLEEPING && p->chan == chan)
       {
-        p->state = RUNNABLE;
+        wakeproc(p);
       }
       release(&p->lock);
     }
   }
 }
 
+// Starvation watchdog, run on every clock tick: flag processes
+// that have been RUNNABLE for longer than starve_thresh.
+void
+starvation_watch(void)
+{
+  struct proc *p;
+  uint64 now = getTime();
+
+  for (p = proc; p < &proc[NPROC]; p++)
+  {
+    acquire(&p->lock);
+    if (p->state == RUNNABLE && !p->starving && now - p->rstart > starve_thresh)
+    {
+      p->starving = 1;
+      p->nstarved++;
+    }
+    release(&p->lock);
+  }
+}
+
+// Per-CPU timer interrupt bookkeeping: count the interrupt
+// and sample the run-queue length. The scan takes no locks,
+// like procdump(); a slightly stale count is fine here.
+void
+cpustat_tick(void)
+{
+  struct cpustats *st = &mycpu()->stats;
+  struct proc *p;
+  uint64 n = 0;
+
+  for (p = proc; p < &proc[NPROC]; p++)
+  {
+    if (p->state == RUNNABLE)
+      n++;
+  }
+  st->ntimer++;
+  st->nrqsample++;
+  st->rqsum += n;
+  if (n > st->rqmax)
+    st->rqmax = n;
+}
+
+// Copy the statistics of the first n CPUs out to the
+// array of struct cpustats at user address addr.
+// Returns the number of CPUs copied.
+int
+kgetcpustats(uint64 addr, int n)
+{
+  if (n < 0)
+    return -1;
+  if (n > NCPU)
+    n = NCPU;
+  for (int i = 0; i < n; i++)
+  {
+    struct cpustats st = cpus[i].stats;
+    if (copyout(myproc()->pagetable, addr + i * sizeof(st), (char *)&st, sizeof(st)) < 0)
+      return -1;
+  }
+  return n;
+}
+
+// Copy out the run-queue wait histogram of process id (kind
+// WAITHIST_PROC) or CPU id (WAITHIST_CPU), or the wakeup latency
+// histogram (WAKEHIST_PROC, WAKEHIST_CPU), to user address addr.
+int
+kgetwaithist(int kind, int id, uint64 addr)
+{
+  struct proc *p;
+  struct hist h;
+
+  if (kind == WAITHIST_CPU || kind == WAKEHIST_CPU)
+  {
+    if (id < 0 || id >= NCPU)
+      return -1;
+    h = kind == WAITHIST_CPU ? cpus[id].waithist : cpus[id].wakehist;
+  }
+  else if (kind == WAITHIST_PROC || kind == WAKEHIST_PROC)
+  {
+    if (id <= 0 || (p = getproc(id)) == 0)
+      return -1;
+    acquire(&p->lock);
+    if (p->pid != id)
+    {
+      release(&p->lock);
+      return -1;
+    }
+    h = kind == WAITHIST_PROC ? p->waithist : p->wakehist;
+    release(&p->lock);
+  }
+  else
+  {
+    return -1;
+  }
+
+  if (copyout(myproc()->pagetable, addr, (char *)&h, sizeof(h)) < 0)
+    return -1;
+  return 0;
+}
+
+// Read scheduler tunable param (see schedctl.h) and, if val is
+// not negative, set it to val. Returns the old value, or -1.
+int
+kschedctl(int param, int val)
+{
+  int old;
+
+  switch (param)
+  {
+    case SCHEDCTL_INTERACT:
+    {
+      old = interact_thresh;
+      if (val > 100)
+        return -1;
+      if (val >= 0)
+        interact_thresh = val;
+      return old;
+    }
+    case SCHEDCTL_STARVE:
+    {
+      old = starve_thresh / 10000;
+      if (val > 0)
+        starve_thresh = (uint64)val * 10000;
+      return old;
+    }
+    case SCHEDCTL_AGING:
+    {
+      old = sjf_aging;
+      if (val >= 0)
+        sjf_aging = val != 0;
+      return old;
+    }
+    case SCHEDCTL_PROFILE:
+      return prof_setinterval(val);
+    case SCHEDCTL_SYSTIME:
+    {
+      old = systime_on;
+      if (val >= 0)
+        systime_on = val != 0;
+      return old;
+    }
+    case SCHEDCTL_STRACE:
+      return strace_set(val);
+    default:
+      return -1;
+  }
+}
+
+// Set the nice value of process pid (0 means the caller),
+// clamped to NICE_MIN..NICE_MAX. Under MLFQ a process whose nice
+// value goes up moves down to the level it now maps to, if that is
+// lower; it never moves up, so nice() cannot undo demotion.
+// Returns -1 if there is no such process.
+int
+ksetpriority(int pid, int nice)
+{
+  struct proc *p;
+
+  if (pid == 0)
+    pid = myproc()->pid;
+  if (nice < NICE_MIN)
+    nice = NICE_MIN;
+  if (nice > NICE_MAX)
+    nice = NICE_MAX;
+
+  for (p = proc; p < &proc[NPROC]; p++)
+  {
+    acquire(&p->lock);
+    if (p->pid == pid && p->state != UNUSED)
+    {
+      if (nice != p->priority) {
+        p->priority = nice;
+        if (mlfq_level(nice) > p->queue_level) {
+          p->queue_level = mlfq_level(nice);
+          p->time_slice = proc_quantum(p);
+        } else if (p->time_slice > proc_quantum(p)) {
+          // a higher nice value shrinks what is left of the
+          // quantum, but a lower one never tops it up.
+          p->time_slice = proc_quantum(p);
+        }
+      }
+      release(&p->lock);
+      return 0;
+    }
+    release(&p->lock);
+  }
+  return -1;
+}
+
+// Return the nice value of process pid (0 means the caller).
+// As with POSIX getpriority(), -1 is both a valid nice value
+// and the result for a nonexistent pid.
+int
+kgetpriority(int pid)
+{
+  struct proc *p;
+  int nice;
+
+  if (pid == 0)
+    pid = myproc()->pid;
+
+  for (p = proc; p < &proc[NPROC]; p++)
+  {
+    acquire(&p->lock);
+    if (p->pid == pid && p->state != UNUSED)
+    {
+      nice = p->priority;
+      release(&p->lock);
+      return nice;
+    }
+    release(&p->lock);
+  }
+  return -1;
+}
+
 // Kill the process with the given pid.
 // The victim won't exit until it tries to return
 // to user space (see usertrap() in trap.c).
@@ -1024,7 +1429,7 @@ int kkill(int pid)
       if (p->state == SLEEPING)
       {
         // Wake process from sleep().
-        p->state = RUNNABLE;
+        wakeproc(p);
       }
       release(&p->lock);
       return 0;
@@ -1115,17 +1520,16 @@ void procdump(void)
 }
 
 //helper to getprocinfo
+// Find the process with pid. No locks: proc[] is never freed,
+// and the caller rechecks p->pid under p->lock if the slot
+// might have been reused since.
 struct proc *
 getproc(int pid)
 {
     struct proc *p;
     for(p = proc; p < &proc[NPROC]; p++){
-        acquire(&p->lock);
-        if(p->pid == pid){
-          release(&p->lock);
+        if(__atomic_load_n(&p->pid, __ATOMIC_RELAXED) == pid)
           return p;
-        }
-        release(&p->lock);
       }
     return 0;
 }
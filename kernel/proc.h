@@ -1,3 +1,6 @@
+#include "procinfo.h"
+#include "syscall.h"
+
 // Scheduling policy used in this kernel build.
 enum sched_policy {
   RR   = 0,
@@ -30,13 +33,47 @@ struct context {
   uint64 s11;
 };
 
+// A nanosleep() deadline (see timer.c).
+struct timer {
+  uint64 deadline;
+  struct proc *p;
+};
+
+// A CPU's pending deadlines, as a min-heap.
+struct timerq {
+  struct spinlock lock;
+  int n;
+  struct timer heap[NPROC];
+};
+
 // Per-CPU state.
+// A CPU's place in the queue of an MCS lock (see spinlock.c),
+// on its own cache line so that each waiter spins locally.
+#define NMCS 4   // MCS locks a CPU may hold or wait for at once
+struct mcsnode {
+  struct mcsnode *next;       // next waiter, once it has linked in
+  int locked;                 // still waiting? cleared by the holder
+} __attribute__((aligned(CACHELINE)));
+
 struct cpu {
   struct proc *proc;          // The process running on this cpu, or null.
   struct context context;     // swtch() here to enter scheduler().
   int noff;                   // Depth of push_off() nesting.
   int intena;                 // Were interrupts enabled before push_off()?
-};
+  int handoff;                // pid donated this CPU by yield_to()/send(), or 0.
+  uint64 handoff_slice;       // donor's remaining time_slice.
+  struct hist waithist;       // RUNNABLE-to-dispatch waits of processes run here.
+  struct hist wakehist;       // wakeup-to-user-space latencies of returns here.
+  struct cpustats stats;      // see getcpustats()
+  uint64 pickstart;           // cycle count when this CPU began choosing a process
+  uint64 next_tick;           // when the next scheduler tick is due
+  uint64 next_prof;           // when the next profiler sample is due
+  struct timerq timers;       // deadlines of nanosleep()s started here
+  struct mcsnode mcs[NMCS];   // queue nodes for MCS locks
+  int mcsused;                // bitmask of mcs[] in use
+  uint64 rcu_gen;             // quiescent states passed (see rcu.c)
+  int rcu_idle;               // halted in wfi: quiescent until it wakes
+} __attribute__((aligned(CACHELINE)));  // no false sharing between CPUs
 
 extern struct cpu cpus[NCPU];
 
@@ -91,7 +128,8 @@ struct trapframe {
   /* 280 */ uint64 t6;
 };
 
-enum procstate { UNUSED, USED, SLEEPING, RUNNABLE, RUNNING, ZOMBIE };
+// State of a process in send()/recv() (see ipc.c).
+enum ipcstate { IPC_IDLE, IPC_SEND, IPC_RECV };
 
 // Per-process state
 struct proc {
@@ -116,6 +154,14 @@ struct proc {
   struct file *ofile[NOFILE];  // Open files
   struct inode *cwd;           // Current directory
   char name[16];               // Process name (debugging)
+  int donate_to;               // pid to hand the CPU to at the next sched(), or 0
+  int pgid;                    // process group, for CPU quotas (0 = none)
+
+  // ipc_lock must be held when using these:
+  enum ipcstate ipc_state;     // Blocked in send() or recv()?
+  int ipc_peer;                // pid sending to, or receiving from (0 = any)
+  int ipc_len;                 // length of the message in ipc_msg
+  char ipc_msg[IPCMSG];        // message waiting to be received
 
   // metadata for scheduling
   uint64 ctime;                // creation time (time when first became RUNNABLE)
@@ -124,13 +170,52 @@ struct proc {
   uint64 stime;                // first scheduled time
   uint64 ltime;                // last scheduled time
 
+  // CPU time accounting (rtime == utime + ktime)
+  uint64 utime;                // time spent in user space
+  uint64 ktime;                // time spent running in the kernel
+  uint64 wtime;                // time spent RUNNABLE, waiting for a CPU
+  uint64 acct_stamp;           // start of the current user or kernel stretch
+  uint64 uinstret;             // instructions retired in user space
+  uint64 ucycles;              // cycles spent in user space
+  uint64 instret_stamp;        // instret and cycle at the last return to user space
+  uint64 cycle_stamp;
+  uint64 nvcsw;                // times the process gave up the CPU (sleep, yield)
+  uint64 nivcsw;               // times the process was preempted
+  int lastcpu;                 // CPU the process last ran on, or -1
+  uint64 nmigrate;             // dispatches on a different CPU than the last
+
+  // MLFQ level changes
+  uint64 npromote;             // I/O boosts to a higher level
+  uint64 ndemote;              // quantum used up, moved down a level
+  uint64 nboost;               // aging boosts after waiting too long
+
   uint64 time_left;            // Remaining time (in a 10MHz clock) for STCF
   uint64 expected_runtime;     // Hint for SJF/STCF: expected total runtime (in a 10MHz clock).
 
-  int priority;               // smaller = higher priority (for STCF/MLFQ)
+  int priority;               // nice value, NICE_MIN..NICE_MAX; smaller = higher priority
+  int slice_ticks;            // timer ticks used since last dispatched (RR)
+  int rr_skip;                // RR rounds passed over because of a positive nice
   int queue_level;            // MLFQ level (0 = top queue)
   uint64 time_slice;          // remaining time in current level's quantum
-  int demote;                 //time_slice never negative, need to keep track of this
+
+  // interactivity tracking (MLFQ I/O boost)
+  uint64 slptime;             // total time spent sleeping
+  uint64 sleep_start;         // when the process last went to sleep
+  int iowait;                 // sleeping on console or disk I/O?
+  uint64 sleep_recent;        // decaying sleep history, for interactivity()
+  uint64 run_recent;          // decaying run history, for interactivity()
+
+  // run-queue latency (starvation watchdog)
+  uint64 rstart;              // when the process last became RUNNABLE
+  int starving;               // has waited longer than starve_thresh this time?
+  int nstarved;               // times the watchdog flagged the process
+  struct hist waithist;       // RUNNABLE-to-dispatch waits
+  uint64 deadline;            // nanosleep() wakeup time; sleeps on &deadline
+  uint64 sysn[NSYSCALL];      // calls of each system call, while SYSTIME is on
+  uint64 systime[NSYSCALL];   // their total latency
+  struct proc *slnext;        // next in a sleeplock's queue of waiters
+  uint64 wakestamp;           // when last woken, until it next returns to user space
+  struct hist wakehist;       // wakeup-to-user-space latencies
 };
 
 // helper used in getprocinfo() in sysproc.c
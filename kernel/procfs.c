@@ -0,0 +1,334 @@
+//
+// /proc: a synthetic, read-only file system of process and
+// scheduler state.
+//
+// open() of an absolute path under /proc is diverted here
+// (see sys_open). The file's text is generated at open time
+// into a page that later reads copy from, so a process sees
+// a consistent snapshot however small its reads are.
+//
+//   /proc/loadavg          load averages and process counts
+//   /proc/schedstat        policy, per-CPU, exit, profiler and
+//                          system call statistics
+//   /proc/<pid>/status     name, state, parent, nice, size
+//   /proc/<pid>/sched      scheduling counters
+//   /proc/<pid>/stat       times, on one line
+//
+// /proc and /proc/<pid> read as directories (without . and
+// ..), so ls works.
+//
+
+#include "types.h"
+#include "param.h"
+#include "memlayout.h"
+#include "riscv.h"
+#include "spinlock.h"
+#include "sleeplock.h"
+#include "fs.h"
+#include "file.h"
+#include "stat.h"
+#include "proc.h"
+#include "defs.h"
+
+extern struct proc proc[NPROC];
+extern struct spinlock wait_lock;
+
+static char *states[] = {
+  [UNUSED]    "unused",
+  [USED]      "used",
+  [SLEEPING]  "sleeping",
+  [RUNNABLE]  "runnable",
+  [RUNNING]   "running",
+  [ZOMBIE]    "zombie"
+};
+
+static char *policies[] = {
+  [RR]   "RR",
+  [FIFO] "FIFO",
+  [SJF]  "SJF",
+  [STCF] "STCF",
+  [MLFQ] "MLFQ",
+};
+
+// Load averages over 1, 5 and 15 minutes of the number of
+// RUNNABLE and RUNNING processes, in fixed point with FSHIFT
+// fraction bits, updated every clock tick (about 1/10 s).
+#define FSHIFT 16
+#define FIXED_1 (1 << FSHIFT)
+static uint64 loadexp[3] = {
+  65427,  // FIXED_1 * exp(-1/600)
+  65514,  // FIXED_1 * exp(-1/3000)
+  65529,  // FIXED_1 * exp(-1/9000)
+};
+static uint64 loadavg[3];
+
+// Called by CPU 0 on each clock tick.
+void
+loadavg_tick(void)
+{
+  struct proc *p;
+  uint64 n = 0;
+
+  // no locks, like procdump(): an approximate count will do.
+  for(p = proc; p < &proc[NPROC]; p++){
+    if(p->state == RUNNABLE || p->state == RUNNING)
+      n++;
+  }
+  for(int i = 0; i < 3; i++)
+    loadavg[i] = (loadavg[i] * loadexp[i] + n * FIXED_1 * (FIXED_1 - loadexp[i])) >> FSHIFT;
+}
+
+// Format fixed-point x as "i.ff".
+static int
+fmtload(char *buf, int size, uint64 x)
+{
+  uint64 frac = ((x & (FIXED_1 - 1)) * 100) >> FSHIFT;
+  return snprintf(buf, size, "%lu.%s%lu", x >> FSHIFT, frac < 10 ? "0" : "", frac);
+}
+
+static int
+gen_loadavg(char *buf, int size)
+{
+  struct proc *p;
+  int n = 0, nrun = 0, nproc = 0, lastpid = 0;
+
+  for(int i = 0; i < 3; i++){
+    n += fmtload(buf + n, size - n, loadavg[i]);
+    n += snprintf(buf + n, size - n, " ");
+  }
+  for(p = proc; p < &proc[NPROC]; p++){
+    acquire(&p->lock);
+    if(p->state != UNUSED){
+      nproc++;
+      if(p->state == RUNNABLE || p->state == RUNNING)
+        nrun++;
+      if(p->pid > lastpid)
+        lastpid = p->pid;
+    }
+    release(&p->lock);
+  }
+  n += snprintf(buf + n, size - n, "%d/%d %d\n", nrun, nproc, lastpid);
+  return n;
+}
+
+static uint64
+mean(struct hist *h)
+{
+  return h->count ? h->sum / h->count : 0;
+}
+
+static int
+gen_schedstat(char *buf, int size)
+{
+  struct exitstats st;
+  int n;
+
+  n = snprintf(buf, size, "policy %s\n", policies[SCHED_POLICY]);
+  n += snprintf(buf + n, size - n, "# cpu busy idle sched switches timerints\n");
+  for(int i = 0; i < NCPU; i++){
+    struct cpustats *cs = &cpus[i].stats;
+    if(cs->ntimer == 0)
+      continue;
+    n += snprintf(buf + n, size - n, "cpu%d %lu %lu %lu %lu %lu\n", i,
+                  cs->busy, cs->idle, cs->sched, cs->nswitch, cs->ntimer);
+  }
+  exitstats_get(&st, 0);
+  n += snprintf(buf + n, size - n, "# exited turnaround response waiting (means)\n");
+  n += snprintf(buf + n, size - n, "exit %lu %lu %lu %lu\n", st.turnaround.count,
+                mean(&st.turnaround), mean(&st.response), mean(&st.waiting));
+  n += snprintf(buf + n, size - n, "# profile interval dropped\n");
+  n += snprintf(buf + n, size - n, "profile %lu %lu\n", prof_interval, prof_dropped());
+  n += snprintf(buf + n, size - n, "# syscalls systime strace_pid strace_dropped\n");
+  n += snprintf(buf + n, size - n, "syscalls %d %d %lu\n", systime_on, strace_pid, strace_dropped());
+  return n;
+}
+
+enum { PID_STATUS, PID_SCHED, PID_STAT };
+
+static char *pidfiles[] = {
+  [PID_STATUS] "status",
+  [PID_SCHED]  "sched",
+  [PID_STAT]   "stat",
+};
+
+// Generate file kind of process pid. Returns -1 if there
+// is no such process.
+static int
+gen_pid(int pid, int kind, char *buf, int size)
+{
+  struct proc *p;
+  int n, ppid;
+
+  for(p = proc; p < &proc[NPROC]; p++){
+    if(p->pid == pid)
+      break;
+  }
+  if(p == &proc[NPROC])
+    return -1;
+
+  acquire(&wait_lock);
+  ppid = p->parent ? p->parent->pid : 0;
+  release(&wait_lock);
+
+  acquire(&p->lock);
+  if(p->pid != pid || p->state == UNUSED){
+    release(&p->lock);
+    return -1;
+  }
+  switch(kind){
+  case PID_STATUS:
+    n = snprintf(buf, size,
+                 "Name:\t%s\nState:\t%s\nPid:\t%d\nPPid:\t%d\nPgid:\t%d\n"
+                 "Nice:\t%d\nSize:\t%lu\nKilled:\t%d\n",
+                 p->name, states[p->state], p->pid, ppid, p->pgid,
+                 p->priority, p->sz, p->killed);
+    break;
+  case PID_SCHED:
+    n = snprintf(buf, size,
+                 "queue_level %d\ntime_slice %lu\nexpected_runtime %lu\ntime_left %lu\n"
+                 "interactivity %d\nnvcsw %lu\nnivcsw %lu\nnmigrate %lu\n"
+                 "npromote %lu\nndemote %lu\nnboost %lu\nnstarved %d\nmaxwait %lu\n",
+                 p->queue_level, p->time_slice, p->expected_runtime, p->time_left,
+                 interactivity(p), p->nvcsw, p->nivcsw, p->nmigrate,
+                 p->npromote, p->ndemote, p->nboost, p->nstarved, p->waithist.max);
+    break;
+  default:
+    // pid (name) state ppid utime ktime wtime slptime rtime ctime stime etime nice
+    n = snprintf(buf, size, "%d (%s) %c %d %lu %lu %lu %lu %lu %lu %lu %lu %d\n",
+                 p->pid, p->name, "?USRRZ"[p->state], ppid,
+                 p->utime, p->ktime, p->wtime, p->slptime, p->rtime,
+                 p->ctime, p->stime, p->etime, p->priority);
+    break;
+  }
+  release(&p->lock);
+  return n;
+}
+
+// Append a directory entry for name to the listing in buf.
+static int
+gen_dirent(char *buf, int n, int size, char *name)
+{
+  struct dirent de;
+
+  if(n + sizeof(de) > size)
+    return n;
+  memset(&de, 0, sizeof(de));
+  de.inum = 1;   // any nonzero value: the entry is in use
+  strncpy(de.name, name, DIRSIZ);
+  memmove(buf + n, &de, sizeof(de));
+  return n + sizeof(de);
+}
+
+// Parse a decimal pid at *s, advancing s. Returns 0 if
+// there is none.
+static int
+parsepid(char **s)
+{
+  int pid = 0;
+
+  if(**s < '0' || **s > '9')
+    return 0;
+  while(**s >= '0' && **s <= '9'){
+    pid = pid * 10 + (**s - '0');
+    (*s)++;
+  }
+  return pid;
+}
+
+// Is path "/proc" or below it?
+int
+procfs_match(char *path)
+{
+  return strncmp(path, "/proc", 5) == 0 && (path[5] == 0 || path[5] == '/');
+}
+
+// Open path, for which procfs_match() is true, for reading.
+// Returns 0 if there is no such file.
+struct file*
+procfs_open(char *path)
+{
+  struct file *f;
+  char *buf, *s = path + 5;
+  char name[DIRSIZ];
+  struct proc *p;
+  int n = -1, type = T_FILE;
+
+  if((buf = kalloc()) == 0)
+    return 0;
+
+  while(*s == '/')
+    s++;
+  if(*s == 0){
+    type = T_DIR;
+    n = gen_dirent(buf, 0, PGSIZE, "loadavg");
+    n = gen_dirent(buf, n, PGSIZE, "schedstat");
+    for(p = proc; p < &proc[NPROC]; p++){
+      acquire(&p->lock);
+      int pid = p->state != UNUSED ? p->pid : 0;
+      release(&p->lock);
+      if(pid){
+        snprintf(name, sizeof(name), "%d", pid);
+        n = gen_dirent(buf, n, PGSIZE, name);
+      }
+    }
+  } else if(strncmp(s, "loadavg", 8) == 0){
+    n = gen_loadavg(buf, PGSIZE);
+  } else if(strncmp(s, "schedstat", 10) == 0){
+    n = gen_schedstat(buf, PGSIZE);
+  } else {
+    int pid = parsepid(&s);
+    while(*s == '/')
+      s++;
+    if(pid == 0){
+      n = -1;
+    } else if(*s == 0){
+      if(gen_pid(pid, PID_STATUS, buf, PGSIZE) >= 0){
+        type = T_DIR;
+        n = 0;
+        for(int i = 0; i < NELEM(pidfiles); i++)
+          n = gen_dirent(buf, n, PGSIZE, pidfiles[i]);
+      }
+    } else {
+      for(int i = 0; i < NELEM(pidfiles); i++){
+        if(strncmp(s, pidfiles[i], DIRSIZ) == 0)
+          n = gen_pid(pid, i, buf, PGSIZE);
+      }
+    }
+  }
+
+  if(n < 0 || (f = filealloc()) == 0){
+    kfree(buf);
+    return 0;
+  }
+  f->type = FD_PROC;
+  f->readable = 1;
+  f->writable = 0;
+  f->procbuf = buf;
+  f->proclen = n;
+  f->proctype = type;
+  f->off = 0;
+  return f;
+}
+
+// Read from a /proc file's snapshot.
+int
+procfs_read(struct file *f, uint64 addr, int n)
+{
+  if(f->off >= f->proclen)
+    return 0;
+  if(n > f->proclen - f->off)
+    n = f->proclen - f->off;
+  if(copyout(myproc()->pagetable, addr, f->procbuf + f->off, n) < 0)
+    return -1;
+  f->off += n;
+  return n;
+}
+
+void
+procfs_stat(struct file *f, struct stat *st)
+{
+  memset(st, 0, sizeof(*st));
+  st->type = f->proctype;
+  st->nlink = 1;
+  st->size = f->proclen;
+}
@@ -1,4 +1,11 @@
+#ifndef PROCINFO_H
+#define PROCINFO_H
+
 #include "types.h"
+#include "hist.h"
+
+// Process states, as in struct proc and procinfo.state.
+enum procstate { UNUSED, USED, SLEEPING, RUNNABLE, RUNNING, ZOMBIE };
 
 // lightweight snapshot of proc, containing data to be printed for evaluation 
 struct procinfo {
@@ -14,4 +21,101 @@ struct procinfo {
   int priority;
   int queue_level;
   int time_slice;
-};
\ No newline at end of file
+  uint64 utime;            // rtime split into user and kernel time
+  uint64 ktime;
+  uint64 instret;          // instructions retired in user space
+  uint64 cycles;           // cycles in user space
+  uint64 wtime;            // time spent RUNNABLE, waiting for a CPU
+  uint64 slptime;
+  uint64 nvcsw;            // voluntary context switches
+  uint64 nivcsw;           // involuntary (preempted) context switches
+  uint64 nmigrate;         // times dispatched on a different CPU than last time
+  uint64 npromote;         // MLFQ I/O boosts to a higher level
+  uint64 ndemote;          // MLFQ demotions
+  uint64 nboost;           // MLFQ aging boosts
+  int interactivity;
+  int pgid;
+  int nstarved;
+  uint64 maxwait;
+};
+
+// kinds for getwaithist()
+#define WAITHIST_PROC 1   // id is a pid
+#define WAITHIST_CPU  2   // id is a CPU number
+#define WAKEHIST_PROC 3   // wakeup-to-user-space latency; id is a pid
+#define WAKEHIST_CPU  4   // the same, of returns to user space on CPU id
+
+// CPU quota and throttling statistics of a process group.
+struct pgroupinfo {
+  int pgid;
+  uint64 quota;           // CPU time allowed per period (10MHz clock)
+  uint64 period;
+  uint64 used;            // CPU time used so far this period
+  int throttled;          // over quota until the period ends?
+  uint64 nthrottled;      // periods in which the group hit its quota
+  uint64 throttled_time;  // total time spent throttled
+};
+
+// Times of every process that has exited since the last reset,
+// in units of the 10MHz clock (see exitstats()).
+struct exitstats {
+  struct hist turnaround;  // etime - ctime
+  struct hist response;    // stime - ctime
+  struct hist waiting;     // time spent RUNNABLE
+};
+
+// Scheduler statistics of one CPU (see getcpustats()).
+// Times are in cycles of that CPU's own cycle counter.
+struct cpustats {
+  uint64 idle;          // cycles halted in wfi with nothing to run
+  uint64 busy;          // cycles running processes
+  uint64 sched;         // cycles in the scheduler picking processes
+  struct hist decide;   // cycles from one dispatch (or wfi) to the next dispatch
+  uint64 nswitch;       // processes dispatched
+  uint64 ntimer;        // timer interrupts
+  uint64 nrqsample;     // run-queue length samples, one per timer interrupt
+  uint64 rqsum;         // sum of the sampled lengths
+  uint64 rqmax;
+};
+
+// One profiler sample (see getprofile()): where a CPU was when
+// the sampling timer interrupted it.
+#define PROFDEPTH 8
+struct profsample {
+  int cpu;
+  int pid;                 // 0 if the CPU was in the scheduler
+  int user;                // interrupted in user mode?
+  char name[16];
+  uint64 pc;               // interrupted pc
+  uint64 stack[PROFDEPTH]; // return addresses by frame pointer, innermost first; 0 ends
+};
+
+// Contention statistics of one lock class, all the spinlocks
+// initialized with the same name (see getlockstat()).
+// Times are in CPU cycles.
+struct lockstat {
+  char name[16];
+  uint64 nacquire;
+  uint64 ncontended;       // acquisitions that had to spin
+  uint64 spin;             // cycles spent spinning
+  uint64 maxhold;          // longest time held
+  // for the classes of sleeplocks, named after them:
+  uint64 nsleepacq;        // acquiresleep() calls
+  uint64 nspun;            // acquisitions that spun while the holder ran
+  uint64 nslept;           // acquisitions that queued and slept
+  uint64 wait;             // time spent in acquiresleep() (10MHz clock)
+};
+
+// One traced system call (see getstrace()).
+#define STRACESTR 32
+struct straceent {
+  uint64 time;             // when the call returned (10MHz clock)
+  uint64 dur;              // latency
+  int pid;
+  int num;                 // SYS_* number
+  uint64 arg[6];           // a0-a5 on entry
+  uint64 ret;
+  char str[STRACESTR];     // path argument of exec, open etc., else empty
+};
+
+#endif // PROCINFO_H
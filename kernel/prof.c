@@ -0,0 +1,165 @@
+//
+// Sampling profiler.
+//
+// While profiling is on (schedctl(SCHEDCTL_PROFILE, us)), each
+// CPU's timer also fires every prof_interval clock units, and
+// clockintr() calls prof_sample() to record the interrupted pc,
+// the process, the privilege mode, and a short frame-pointer
+// walk of the stack into that CPU's ring buffer. getprofile()
+// drains the buffers; prof-fold.py turns the samples into
+// folded stacks for flame graphs.
+//
+// Kernel samples walk the kernel stack from prof_sample()'s own
+// frame: kernelvec leaves s0 alone, so the walk passes through
+// the trap path (clockintr, devintr, kerneltrap, kernelvec) into
+// the interrupted code, and the host script cuts the trap path
+// off. User samples walk the user stack from the trapframe's s0.
+//
+
+#include "types.h"
+#include "param.h"
+#include "memlayout.h"
+#include "riscv.h"
+#include "spinlock.h"
+#include "proc.h"
+#include "schedctl.h"
+#include "defs.h"
+
+#define NPROFSAMPLE 128   // per CPU
+
+struct profbuf {
+  struct spinlock lock;
+  int head;               // next sample to read
+  int n;                  // samples in the buffer
+  uint64 ndropped;        // samples lost to a full buffer
+  struct profsample buf[NPROFSAMPLE];
+};
+
+static struct profbuf prof[NCPU];
+
+uint64 prof_interval;     // clock units between samples; 0 = off
+
+void
+profinit(void)
+{
+  for(int i = 0; i < NCPU; i++)
+    initlock(&prof[i].lock, "prof");
+}
+
+// Set the sampling interval to us microseconds (0 turns the
+// profiler off) unless us is negative. Returns the old interval,
+// or -1 if us is below PROF_MIN_US.
+int
+prof_setinterval(int us)
+{
+  int old = prof_interval / 10;
+
+  if(us > 0 && us < PROF_MIN_US)
+    return -1;
+  if(us >= 0)
+    prof_interval = (uint64)us * 10;
+  return old;
+}
+
+// Walk kernel frames from fp, staying on fp's stack page.
+static void
+walk_kernel(struct profsample *s, uint64 fp)
+{
+  uint64 top = PGROUNDUP(fp), bottom = top - PGSIZE;
+  int i = 0;
+
+  while(i < PROFDEPTH && fp - 16 >= bottom && fp <= top && (fp & 0xf) == 0){
+    s->stack[i++] = *(uint64 *)(fp - 8);
+    fp = *(uint64 *)(fp - 16);
+  }
+}
+
+// Walk user frames from fp through p's page table. Each
+// frame record is 16 bytes below fp, so within one page.
+static void
+walk_user(struct profsample *s, struct proc *p, uint64 fp)
+{
+  int i = 0;
+
+  while(i < PROFDEPTH && fp >= 16 && (fp & 0xf) == 0){
+    uint64 va = fp - 16;
+    uint64 pa = walkaddr(p->pagetable, PGROUNDDOWN(va));
+    if(pa == 0)
+      break;
+    uint64 *frame = (uint64 *)(pa + (va - PGROUNDDOWN(va)));
+    s->stack[i++] = frame[1];
+    if(frame[0] <= fp)
+      break;   // stacks grow down; callers' frames are above
+    fp = frame[0];
+  }
+}
+
+// Record where this CPU was interrupted. Called from clockintr()
+// with interrupts off.
+void
+prof_sample(void)
+{
+  struct profbuf *b = &prof[cpuid()];
+  struct proc *p = myproc();
+  struct profsample *s;
+
+  acquire(&b->lock);
+  if(b->n == NPROFSAMPLE){
+    b->ndropped++;
+    release(&b->lock);
+    return;
+  }
+  s = &b->buf[(b->head + b->n++) % NPROFSAMPLE];
+  memset(s, 0, sizeof(*s));
+  s->cpu = cpuid();
+  s->pc = r_sepc();
+  s->user = (r_sstatus() & SSTATUS_SPP) == 0;
+  if(p){
+    s->pid = p->pid;
+    safestrcpy(s->name, p->name, sizeof(s->name));
+  }
+  if(s->user && p)
+    walk_user(s, p, p->trapframe->s0);
+  else
+    walk_kernel(s, r_fp());
+  release(&b->lock);
+}
+
+// Copy up to n samples, oldest first per CPU, to user address
+// addr, removing them from the buffers. Returns the number copied.
+int
+kgetprofile(uint64 addr, int n)
+{
+  struct profsample s;
+  int got = 0;
+
+  for(int i = 0; i < NCPU && got < n; i++){
+    struct profbuf *b = &prof[i];
+    for(;;){
+      acquire(&b->lock);
+      if(b->n == 0 || got == n){
+        release(&b->lock);
+        break;
+      }
+      s = b->buf[b->head];
+      b->head = (b->head + 1) % NPROFSAMPLE;
+      b->n--;
+      release(&b->lock);
+      if(copyout(myproc()->pagetable, addr + got * sizeof(s), (char *)&s, sizeof(s)) < 0)
+        return -1;
+      got++;
+    }
+  }
+  return got;
+}
+
+// Samples lost so far because a buffer was full.
+uint64
+prof_dropped(void)
+{
+  uint64 n = 0;
+
+  for(int i = 0; i < NCPU; i++)
+    n += prof[i].ndropped;
+  return n;
+}
@@ -0,0 +1,83 @@
+//
+// Read-copy-update, for tables whose entries are looked up far
+// more often than they are removed.
+//
+// Readers bracket a lookup with rcu_read_lock() and
+// rcu_read_unlock(), which only turn interrupts off, and read
+// the table's pointers with rcu_deref(). A writer unpublishes an
+// entry with rcu_assign() and calls synchronize_rcu() before
+// freeing it: once every CPU has passed through a quiescent
+// state, no reader can still be looking at the old entry.
+//
+// A CPU is in a quiescent state whenever it can take a trap or
+// goes around its scheduler loop, since readers keep interrupts
+// off and never sleep. rcu_qs() counts these in c->rcu_gen; a
+// CPU whose count is still 0 has not started scheduling. A CPU
+// halted with nothing to run is quiescent for as long as it is
+// halted, so grace periods need not wait for it to wake.
+//
+
+#include "types.h"
+#include "param.h"
+#include "memlayout.h"
+#include "riscv.h"
+#include "spinlock.h"
+#include "proc.h"
+#include "defs.h"
+
+void
+rcu_read_lock(void)
+{
+  push_off();
+}
+
+void
+rcu_read_unlock(void)
+{
+  pop_off();
+}
+
+// This CPU is not inside a read-side section.
+// Interrupts must be off.
+void
+rcu_qs(void)
+{
+  struct cpu *c = mycpu();
+
+  __sync_synchronize();
+  __atomic_store_n(&c->rcu_gen, c->rcu_gen + 1, __ATOMIC_RELAXED);
+}
+
+// This CPU is halting (idle = 1) or has woken up (idle = 0).
+// Interrupts must be off.
+void
+rcu_idle(int idle)
+{
+  struct cpu *c = mycpu();
+
+  __atomic_store_n(&c->rcu_idle, idle, __ATOMIC_RELAXED);
+  // a waking CPU's lookups must see what synchronize_rcu()'s
+  // caller unpublished, or the caller must see it awake.
+  __sync_synchronize();
+}
+
+// Wait until every read-side section that might have begun
+// before the call has ended. Must not hold any locks.
+void
+synchronize_rcu(void)
+{
+  uint64 snap[NCPU];
+
+  __sync_synchronize();
+  for(int i = 0; i < NCPU; i++)
+    snap[i] = __atomic_load_n(&cpus[i].rcu_gen, __ATOMIC_RELAXED);
+  for(int i = 0; i < NCPU; i++){
+    if(snap[i] == 0)
+      continue;
+    // yielding also takes this CPU around its scheduler loop.
+    while(__atomic_load_n(&cpus[i].rcu_gen, __ATOMIC_RELAXED) == snap[i] &&
+          !__atomic_load_n(&cpus[i].rcu_idle, __ATOMIC_RELAXED))
+      yield();
+  }
+  __sync_synchronize();
+}
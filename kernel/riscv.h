@@ -273,6 +273,26 @@ r_mcounteren()
   return x;
 }
 
+// Supervisor-mode Counter-Enable: which of cycle, time
+// and instret user mode may read.
+#define COUNTEREN_CY (1L << 0)
+#define COUNTEREN_TM (1L << 1)
+#define COUNTEREN_IR (1L << 2)
+
+static inline void 
+w_scounteren(uint64 x)
+{
+  asm volatile("csrw scounteren, %0" : : "r" (x));
+}
+
+static inline uint64
+r_scounteren()
+{
+  uint64 x;
+  asm volatile("csrr %0, scounteren" : "=r" (x) );
+  return x;
+}
+
 // machine-mode cycle counter
 static inline uint64
 r_time()
@@ -336,6 +356,15 @@ r_ra()
   return x;
 }
 
+// the frame pointer (s0) of the calling function.
+static inline uint64
+r_fp()
+{
+  uint64 x;
+  asm volatile("mv %0, s0" : "=r" (x) );
+  return x;
+}
+
 // flush the TLB.
 static inline void
 sfence_vma()
@@ -350,6 +379,19 @@ static inline uint64 getTime() {
   return (uint64) time;
 }
 
+// this hart's cycle and retired-instruction counters.
+static inline uint64 getCycles() {
+  unsigned long x;
+  asm volatile ("rdcycle %0" : "=r" (x));
+  return (uint64) x;
+}
+
+static inline uint64 getInstret() {
+  unsigned long x;
+  asm volatile ("rdinstret %0" : "=r" (x));
+  return (uint64) x;
+}
+
 typedef uint64 pte_t;
 typedef uint64 *pagetable_t; // 512 PTEs
 
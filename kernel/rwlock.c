@@ -0,0 +1,95 @@
+// Reader-writer spin locks, for read-mostly tables.
+//
+// Like spinlocks, they keep interrupts off while held. Waiting
+// writers stop new readers from getting in, so a steady stream
+// of readers cannot starve a writer; in turn a reader must not
+// take a read lock it already holds, or a writer arriving in
+// between would deadlock them. Acquisitions are counted in the
+// lock statistics of the class named after the lock, as for
+// spinlocks.
+
+#include "types.h"
+#include "param.h"
+#include "memlayout.h"
+#include "riscv.h"
+#include "spinlock.h"
+#include "rwlock.h"
+#include "proc.h"
+#include "defs.h"
+
+void
+initrwlock(struct rwlock *rw, char *name)
+{
+  rw->name = name;
+  rw->cnt = 0;
+  rw->wwait = 0;
+  rw->class = lockstat_class(name);
+}
+
+// Take a read lock if there is no writer, holding or waiting.
+static int
+tryread(struct rwlock *rw)
+{
+  int c = __atomic_load_n(&rw->cnt, __ATOMIC_RELAXED);
+
+  return c >= 0 && __atomic_load_n(&rw->wwait, __ATOMIC_RELAXED) == 0 &&
+         __atomic_compare_exchange_n(&rw->cnt, &c, c + 1, 0,
+                                     __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+// Take the write lock if nobody holds the lock.
+static int
+trywrite(struct rwlock *rw)
+{
+  int zero = 0;
+
+  return __atomic_compare_exchange_n(&rw->cnt, &zero, -1, 0,
+                                     __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+void
+acquireread(struct rwlock *rw)
+{
+  uint64 t0 = 0;
+
+  push_off();
+  if(!tryread(rw)){
+    t0 = getCycles();
+    while(!tryread(rw))
+      ;
+  }
+  lockstat_acquire(rw->class, t0);
+}
+
+void
+releaseread(struct rwlock *rw)
+{
+  if(__atomic_fetch_sub(&rw->cnt, 1, __ATOMIC_RELEASE) <= 0)
+    panic("releaseread");
+  pop_off();
+}
+
+void
+acquirewrite(struct rwlock *rw)
+{
+  uint64 t0 = 0;
+
+  push_off();
+  __atomic_fetch_add(&rw->wwait, 1, __ATOMIC_RELAXED);
+  if(!trywrite(rw)){
+    t0 = getCycles();
+    while(!trywrite(rw))
+      ;
+  }
+  __atomic_fetch_sub(&rw->wwait, 1, __ATOMIC_RELAXED);
+  lockstat_acquire(rw->class, t0);
+}
+
+void
+releasewrite(struct rwlock *rw)
+{
+  if(rw->cnt != -1)
+    panic("releasewrite");
+  __atomic_store_n(&rw->cnt, 0, __ATOMIC_RELEASE);
+  pop_off();
+}
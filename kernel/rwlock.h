@@ -0,0 +1,9 @@
+// Reader-writer spin lock: any number of readers, or one writer.
+struct rwlock {
+  int cnt;           // readers holding the lock, or -1 for a writer
+  int wwait;         // writers waiting; new readers hold off for them
+  int class;         // lock statistics class (see spinlock.c)
+
+  // For debugging:
+  char *name;        // Name of lock.
+};
@@ -0,0 +1,13 @@
+// Scheduler tunables, read and set with schedctl(param, val).
+// A negative val only reads the current value.
+
+#define SCHEDCTL_INTERACT  1   // MLFQ: interactivity score (0-100) needed for an I/O boost
+#define SCHEDCTL_STARVE    2   // ms a process may wait RUNNABLE before it is flagged as starving
+#define SCHEDCTL_AGING     3   // SJF/STCF: 1 = run starving processes first, 0 = off
+#define SCHEDCTL_PROFILE   4   // us between profiler samples on each CPU, 0 = off
+#define SCHEDCTL_SYSTIME   5   // 1 = keep system call latency histograms, 0 = off
+#define SCHEDCTL_STRACE    6   // pid whose system calls are traced, 0 = none
+
+// Shortest profiler interval: a shorter one would have the timer
+// fire again before the handler has returned.
+#define PROF_MIN_US 100
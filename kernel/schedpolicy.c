@@ -0,0 +1,299 @@
+//
+// Scheduling policy decisions (see schedpolicy.h).
+//
+// proc.c does the locking, dispatching and accounting around
+// these; sim/schedsim.c replays workload traces through them
+// on the host with virtual time. The pick loops at the end are
+// the ones both run, so the simulator dispatches in the same
+// order as the kernel.
+//
+
+#include "types.h"
+#include "param.h"
+#include "schedpolicy.h"
+
+static const uint64 quantum[3] = {0.5*10000, 1*10000, 2*10000};  // MLFQ quantum per level: 0.5, 1, 2 ms
+
+// Run and sleep history older than about this long is decayed
+// out of the interactivity score (5 s of a 10MHz clock).
+#define INTERACT_WINDOW (5000*10000)
+
+// SJF key: the expected runtime hint. 0 means "no info".
+// A process aged by the starvation watchdog goes first.
+uint64
+sjf_key(uint64 expected, int aged)
+{
+  if(aged)
+    return 0;
+  return expected ? expected : SCHED_NOKEY;
+}
+
+// STCF key: the time left of the hinted runtime.
+uint64
+stcf_key(uint64 expected, uint64 time_left, int aged)
+{
+  if(aged)
+    return 0;
+  return expected ? time_left : SCHED_NOKEY;
+}
+
+// STCF time left of a process that has just set its runtime
+// hint. One more than the hint, so a process that runs exactly
+// as long as it said is not yet counted as done.
+uint64
+stcf_time_left(uint64 expected)
+{
+  return expected + 1;
+}
+
+// Should a run before b?
+int
+sched_key_before(struct sched_key *a, struct sched_key *b)
+{
+  if(a->key != b->key)
+    return a->key < b->key;
+  if(a->nice != b->nice)
+    return a->nice < b->nice;
+  if(a->ctime != b->ctime)
+    return a->ctime < b->ctime;
+  return a->pid < b->pid;
+}
+
+// Timer ticks a process may run for under RR before it is
+// preempted: negative nice values earn up to 5 ticks.
+int
+rr_ticks(int nice)
+{
+  if(nice < 0)
+    return 1 + -nice / 5;
+  return 1;
+}
+
+// Should RR pass over a runnable process this round? A positive
+// nice value passes it over in nice/5 out of every 1+nice/5
+// rounds; *skip counts the rounds.
+int
+rr_passover(int nice, int *skip)
+{
+  return nice > 0 && (*skip)++ % (1 + nice / 5) != 0;
+}
+
+// MLFQ level a process with nice value nice starts in.
+int
+mlfq_level(int nice)
+{
+  if(nice <= 0)
+    return 0;
+  if(nice < 10)
+    return 1;
+  return 2;
+}
+
+// MLFQ quantum at level, scaled by the nice value:
+// 2x at NICE_MIN, 1x at 0, 1/20x at NICE_MAX.
+uint64
+mlfq_quantum(int level, int nice)
+{
+  return quantum[level] * (20 - nice) / 20;
+}
+
+// Charge elapsed running time against the MLFQ time *slice,
+// demoting *level once the slice is used up.
+// Returns 1 if the process was demoted.
+int
+mlfq_charge_slice(int *level, uint64 *slice, int nice, uint64 elapsed)
+{
+  if(elapsed < *slice){
+    *slice -= elapsed;
+    return 0;
+  }
+  *slice = 0;
+  if(*level >= 2)
+    return 0;
+  (*level)++;
+  *slice = mlfq_quantum(*level, nice);
+  return 1;
+}
+
+// Aging: a process that has waited longer than cut since it
+// last ran moves up a level with a fresh quantum.
+// Returns 1 if it was boosted.
+int
+mlfq_age(int *level, uint64 *slice, int nice, uint64 waited, uint64 cut)
+{
+  if(waited <= cut || *level == 0)
+    return 0;
+  (*level)--;
+  *slice = mlfq_quantum(*level, nice);
+  return 1;
+}
+
+// I/O boost: an interactive process (score at least thresh) that
+// waited on a device goes back to the level its nice value starts
+// it at, with a fresh quantum, instead of queueing behind CPU hogs.
+// Returns 1 if it was boosted.
+int
+mlfq_wake_boost(int *level, uint64 *slice, int nice, int score, int thresh)
+{
+  if(score < thresh || *level <= mlfq_level(nice))
+    return 0;
+  *level = mlfq_level(nice);
+  *slice = mlfq_quantum(*level, nice);
+  return 1;
+}
+
+// Share of recent history spent sleeping rather than running,
+// 0-100. High for shells and editors, low for CPU hogs.
+int
+interact_score(uint64 sleep_recent, uint64 run_recent)
+{
+  uint64 total = sleep_recent + run_recent;
+
+  if(total == 0)
+    return 0;
+  return (sleep_recent * 100) / total;
+}
+
+// Halve the run/sleep history once it spans more than the
+// window, so that the score tracks recent behavior.
+void
+interact_decay_hist(uint64 *sleep_recent, uint64 *run_recent)
+{
+  while(*sleep_recent + *run_recent > INTERACT_WINDOW){
+    *sleep_recent /= 2;
+    *run_recent /= 2;
+  }
+}
+
+// ---- pick loops ----
+
+// Round robin: one pass over the table, running every dispatchable
+// process in turn unless rr_passover() skips it this round. A
+// handoff left by the last one runs before the pass goes on.
+// Returns 1 if there was any dispatchable process, even if all were
+// passed over, so that the CPU goes around again rather than idle.
+int
+sched_rr(struct sched_ops *ops)
+{
+  struct sched_cand c;
+  int found = 0;
+
+  for(int i = 0; i < ops->nslot; i++){
+    if(!ops->get(ops->arg, i, &c))
+      continue;
+    found = 1;
+    if(!rr_passover(c.nice, c.rr_skip))
+      ops->run(ops->arg, i);
+    ops->put(ops->arg, i);
+    while(ops->handoff && ops->handoff(ops->arg))
+      ;
+  }
+  return found;
+}
+
+// Run the chosen slot best, if it is still dispatchable once held.
+// Returns 1 if it ran.
+static int
+sched_run_best(struct sched_ops *ops, int best)
+{
+  struct sched_cand c;
+
+  if(!ops->get(ops->arg, best, &c))
+    return 0;
+  ops->run(ops->arg, best);
+  ops->put(ops->arg, best);
+  return 1;
+}
+
+// FIFO: the oldest dispatchable process.
+int
+sched_fifo(struct sched_ops *ops)
+{
+  struct sched_cand c;
+  uint64 bctime = 0;
+  int best = -1;
+
+  for(int i = 0; i < ops->nslot; i++){
+    if(!ops->get(ops->arg, i, &c))
+      continue;
+    if(best < 0 || c.ctime < bctime){
+      best = i;
+      bctime = c.ctime;
+    }
+    ops->put(ops->arg, i);
+  }
+  if(best < 0)
+    return 0;
+  // if best raced away, look again rather than idle.
+  sched_run_best(ops, best);
+  return 1;
+}
+
+// Shortest job first (stcf == 0) or shortest time to completion
+// first (stcf == 1). Processes without a hint sort last; if no
+// dispatchable process has one, run a round robin pass instead.
+int
+sched_shortest(struct sched_ops *ops, int stcf)
+{
+  struct sched_cand c;
+  struct sched_key k, bk;
+  int best = -1;
+
+  for(int i = 0; i < ops->nslot; i++){
+    if(!ops->get(ops->arg, i, &c))
+      continue;
+    if(stcf)
+      k.key = stcf_key(c.expected, c.time_left, c.aged);
+    else
+      k.key = sjf_key(c.expected, c.aged);
+    k.nice = c.nice;
+    k.ctime = c.ctime;
+    k.pid = c.pid;
+    if(best < 0 || sched_key_before(&k, &bk)){
+      best = i;
+      bk = k;
+    }
+    ops->put(ops->arg, i);
+  }
+  if(best < 0)
+    return 0;
+  if(bk.key == SCHED_NOKEY)
+    return sched_rr(ops);
+  sched_run_best(ops, best);
+  return 1;
+}
+
+// MLFQ: keep running the process at the highest level that has
+// waited longest since it last ran, until nothing is dispatchable.
+// Before each pick, run any handoff and age starving processes.
+int
+sched_mlfq(struct sched_ops *ops)
+{
+  struct sched_cand c;
+  int found = 0;
+
+  for(;;){
+    if(ops->handoff && ops->handoff(ops->arg)){
+      found = 1;
+      continue;
+    }
+    ops->age(ops->arg);
+
+    int best = -1, blevel = 0;
+    uint64 bltime = 0;
+    for(int i = 0; i < ops->nslot; i++){
+      if(!ops->get(ops->arg, i, &c))
+        continue;
+      if(best < 0 || c.level < blevel || (c.level == blevel && c.ltime < bltime)){
+        best = i;
+        blevel = c.level;
+        bltime = c.ltime;
+      }
+      ops->put(ops->arg, i);
+    }
+    if(best < 0)
+      return found;
+    if(sched_run_best(ops, best))
+      found = 1;
+  }
+}
@@ -0,0 +1,77 @@
+// Scheduling policy decisions, kept free of locks, struct proc
+// and the clock so that the same code builds into the kernel
+// and into the host-side simulator in sim/.
+// Times are in units of the 10MHz clock.
+
+#ifndef SCHEDPOLICY_H
+#define SCHEDPOLICY_H
+
+// What SJF and STCF order runnable processes by.
+struct sched_key {
+  uint64 key;     // smaller runs first; SCHED_NOKEY if there is no hint
+  int nice;       // ties go to the lower nice value,
+  uint64 ctime;   // then to the older process,
+  int pid;        // then to the lower pid.
+};
+
+#define SCHED_NOKEY (~0ULL)
+
+// Defaults of the schedctl() tunables that the policies use.
+#define MLFQ_STARVE_CUT (1000*10000)  // MLFQ aging cutoff (1 s)
+#define INTERACT_THRESH 60            // interactivity score for the I/O boost
+
+// A dispatchable process as the pick loops below see it.
+struct sched_cand {
+  int nice;
+  int pid;
+  uint64 ctime;       // creation: FIFO order, SJF/STCF ties
+  uint64 expected;    // runtime hint, 0 if none
+  uint64 time_left;   // STCF: what is left of the hint
+  int aged;           // waited long enough for SJF/STCF aging
+  int level;          // MLFQ level
+  uint64 ltime;       // when it was last dispatched
+  int *rr_skip;       // RR pass-over count; valid while held
+};
+
+// How the pick loops reach a process table. The kernel locks a
+// slot in get() and unlocks it in put(); the simulator has no
+// locks. run() and the MLFQ hooks also do each side's accounting.
+struct sched_ops {
+  int nslot;
+  // If slot i holds a dispatchable process, fill in *c and return
+  // 1 with the slot held; otherwise return 0 with it not held.
+  int   (*get)(void *arg, int i, struct sched_cand *c);
+  void  (*put)(void *arg, int i);
+  // Run the process in held slot i until it gives up the CPU.
+  void  (*run)(void *arg, int i);
+  // Run a pending yield_to()/send() handoff, returning 1 if there
+  // was one (may be 0); RR and MLFQ call it between picks.
+  // MLFQ: age processes that waited long.
+  int   (*handoff)(void *arg);
+  void  (*age)(void *arg);
+  void *arg;
+};
+
+uint64  sjf_key(uint64 expected, int aged);
+uint64  stcf_key(uint64 expected, uint64 time_left, int aged);
+uint64  stcf_time_left(uint64 expected);
+int     sched_key_before(struct sched_key *a, struct sched_key *b);
+
+int     rr_ticks(int nice);
+int     rr_passover(int nice, int *skip);
+
+int     mlfq_level(int nice);
+uint64  mlfq_quantum(int level, int nice);
+int     mlfq_charge_slice(int *level, uint64 *slice, int nice, uint64 elapsed);
+int     mlfq_age(int *level, uint64 *slice, int nice, uint64 waited, uint64 cut);
+int     mlfq_wake_boost(int *level, uint64 *slice, int nice, int score, int thresh);
+
+int     interact_score(uint64 sleep_recent, uint64 run_recent);
+void    interact_decay_hist(uint64 *sleep_recent, uint64 *run_recent);
+
+int     sched_rr(struct sched_ops *ops);
+int     sched_fifo(struct sched_ops *ops);
+int     sched_shortest(struct sched_ops *ops, int stcf);
+int     sched_mlfq(struct sched_ops *ops);
+
+#endif // SCHEDPOLICY_H
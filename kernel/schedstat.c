@@ -0,0 +1,63 @@
+//
+// Kernel-wide exit statistics: the turnaround, response and
+// waiting time of every process that exits, folded into log2
+// histograms, so that any workload can be scored under the
+// current scheduling policy without instrumenting it.
+//
+
+#include "types.h"
+#include "param.h"
+#include "memlayout.h"
+#include "riscv.h"
+#include "spinlock.h"
+#include "proc.h"
+#include "procinfo.h"
+#include "defs.h"
+
+struct {
+  struct spinlock lock;
+  struct exitstats st;
+} exitstats;
+
+void
+schedstatinit(void)
+{
+  initlock(&exitstats.lock, "exitstats");
+}
+
+// Fold the times of p, which has just exited, into the
+// statistics. Called by the scheduler with p->lock held,
+// once p has switched away for the last time.
+void
+exitstat_add(struct proc *p)
+{
+  acquire(&exitstats.lock);
+  hist_add(&exitstats.st.turnaround, p->etime - p->ctime);
+  hist_add(&exitstats.st.response, p->stime - p->ctime);
+  hist_add(&exitstats.st.waiting, p->wtime);
+  release(&exitstats.lock);
+}
+
+// Copy the statistics into *st, then clear them if reset is set.
+void
+exitstats_get(struct exitstats *st, int reset)
+{
+  acquire(&exitstats.lock);
+  *st = exitstats.st;
+  if(reset)
+    memset(&exitstats.st, 0, sizeof(exitstats.st));
+  release(&exitstats.lock);
+}
+
+// Copy the statistics out to user address addr (if not 0),
+// then clear them if reset is set.
+int
+kexitstats(uint64 addr, int reset)
+{
+  struct exitstats st;
+
+  exitstats_get(&st, reset);
+  if(addr != 0 && copyout(myproc()->pagetable, addr, (char *)&st, sizeof(st)) < 0)
+    return -1;
+  return 0;
+}
@@ -9,34 +9,101 @@
 #include "proc.h"
 #include "sleeplock.h"
 
+// A waiter spins, rather than sleeps, for up to SLSPIN units of
+// the 10MHz clock while the holder is running on another CPU,
+// since it is likely to be done soon and sleeping costs two
+// context switches. Past that it joins the lock's FIFO queue,
+// and releasesleep() hands the lock straight to the first in
+// line, so waiters get it in order and none is overtaken.
+#define SLSPIN 200   // 20 us
+
 void
 initsleeplock(struct sleeplock *lk, char *name)
 {
-  initlock(&lk->lk, "sleep lock");
+  initlock(&lk->lk, name);
   lk->name = name;
   lk->locked = 0;
+  lk->owner = 0;
+  lk->qhead = 0;
+  lk->qtail = 0;
   lk->pid = 0;
 }
 
+// Is lk's holder running on some CPU? A racy peek, made
+// without locks; proc[] is never freed.
+static int
+owner_running(struct sleeplock *lk)
+{
+  struct proc *o = __atomic_load_n(&lk->owner, __ATOMIC_RELAXED);
+
+  return o != 0 && __atomic_load_n(&o->state, __ATOMIC_RELAXED) == RUNNING;
+}
+
+// Take lk if it is free. Caller must hold lk->lk.
+static int
+trytake(struct sleeplock *lk, struct proc *p)
+{
+  if(lk->locked)
+    return 0;
+  lk->locked = 1;
+  lk->owner = p;
+  return 1;
+}
+
 void
 acquiresleep(struct sleeplock *lk)
 {
+  struct proc *p = myproc();
+  uint64 t0 = getTime();
+  int spun = 0, slept = 0;
+
   acquire(&lk->lk);
-  while (lk->locked) {
-    sleep(lk, &lk->lk);
+  if(!trytake(lk, p) && owner_running(lk)){
+    uint64 deadline = getTime() + SLSPIN;
+    spun = 1;
+    release(&lk->lk);
+    while(__atomic_load_n(&lk->locked, __ATOMIC_RELAXED) &&
+          owner_running(lk) && getTime() < deadline)
+      ;
+    acquire(&lk->lk);
   }
-  lk->locked = 1;
-  lk->pid = myproc()->pid;
+  if(lk->owner != p && !trytake(lk, p)){
+    slept = 1;
+    p->slnext = 0;
+    if(lk->qtail)
+      lk->qtail->slnext = p;
+    else
+      lk->qhead = p;
+    lk->qtail = p;
+    while(lk->owner != p)
+      sleep(lk, &lk->lk);
+  }
+  lk->pid = p->pid;
+  lockstat_sleep(&lk->lk, spun && !slept, slept, getTime() - t0);
   release(&lk->lk);
 }
 
 void
 releasesleep(struct sleeplock *lk)
 {
+  struct proc *w;
+
   acquire(&lk->lk);
-  lk->locked = 0;
-  lk->pid = 0;
-  wakeup(lk);
+  if((w = lk->qhead) != 0){
+    // hand the lock to the first waiter; it stays locked.
+    lk->qhead = w->slnext;
+    if(lk->qhead == 0)
+      lk->qtail = 0;
+    lk->owner = w;
+    lk->pid = w->pid;
+    acquire(&w->lock);
+    wakeupproc(w, lk);
+    release(&w->lock);
+  } else {
+    lk->locked = 0;
+    lk->owner = 0;
+    lk->pid = 0;
+  }
   release(&lk->lk);
 }
 
@@ -50,6 +117,3 @@ holdingsleep(struct sleeplock *lk)
   release(&lk->lk);
   return r;
 }
-
-
-
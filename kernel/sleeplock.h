@@ -2,9 +2,11 @@
 struct sleeplock {
   uint locked;       // Is the lock held?
   struct spinlock lk; // spinlock protecting this sleep lock
-  
+  struct proc *owner; // Process holding the lock
+  struct proc *qhead; // Processes waiting, first to be handed it
+  struct proc *qtail; // ... through p->slnext
+
   // For debugging:
   char *name;        // Name of lock.
   int pid;           // Process holding lock
 };
-
@@ -6,14 +6,171 @@
 #include "spinlock.h"
 #include "riscv.h"
 #include "proc.h"
+#include "procinfo.h"
 #include "defs.h"
 
+// Lock statistics are kept by class: all the locks initialized
+// with the same name, such as every "proc" lock. Each CPU counts
+// its own acquisitions, with interrupts off, so the counters need
+// no lock. Times are in CPU cycles.
+struct lockcount {
+  uint64 nacquire;
+  uint64 ncontended;   // acquisitions that had to spin
+  uint64 spin;         // cycles spent spinning
+  uint64 maxhold;      // longest time held
+  uint64 nsleepacq;    // sleeplocks: see struct lockstat
+  uint64 nspun;
+  uint64 nslept;
+  uint64 wait;
+};
+
+static struct lockcount lockcounts[NCPU][NLOCKCLASS] __attribute__((aligned(CACHELINE)));
+static char *classname[NLOCKCLASS] = { "other" };  // class 0: the names that did not fit
+static int nclass = 1;
+static uint classlock;   // a bare lock, since it can't count itself
+
+// Find name's class, adding it if it is new.
+static int
+lockclass(char *name)
+{
+  int i;
+
+  push_off();
+  while(__sync_lock_test_and_set(&classlock, 1) != 0)
+    ;
+  __sync_synchronize();
+  for(i = 1; i < nclass; i++)
+    if(classname[i] == name || strncmp(classname[i], name, 16) == 0)
+      break;
+  if(i == nclass){
+    if(nclass < NLOCKCLASS)
+      classname[nclass++] = name;
+    else
+      i = 0;
+  }
+  __sync_lock_release(&classlock);
+  pop_off();
+  return i;
+}
+
 void
 initlock(struct spinlock *lk, char *name)
+{
+  initlock_kind(lk, name, LOCK_TAS);
+}
+
+// Initialize a lock of kind LOCK_TAS, LOCK_TICKET or LOCK_MCS.
+// All kinds are taken with acquire() and release(). The queued
+// kinds hand the lock to waiters in arrival order, so none
+// starves; a ticket lock's waiters all spin on the lock, an
+// MCS lock's each spin on a node of their own.
+void
+initlock_kind(struct spinlock *lk, char *name, int kind)
 {
   lk->name = name;
   lk->locked = 0;
   lk->cpu = 0;
+  lk->kind = kind;
+  lk->next = 0;
+  lk->owner = 0;
+  lk->tail = 0;
+  lk->node = 0;
+  lk->class = lockclass(name);
+  lk->tacquire = 0;
+}
+
+// Count an acquisition that spun from cycle t0 until now.
+static void
+spun(struct lockcount *lc, uint64 t0)
+{
+  lc->ncontended++;
+  lc->spin += getCycles() - t0;
+}
+
+static void
+tas_acquire(struct spinlock *lk, struct lockcount *lc)
+{
+  // On RISC-V, sync_lock_test_and_set turns into an atomic swap:
+  //   a5 = 1
+  //   s1 = &lk->locked
+  //   amoswap.w.aq a5, a5, (s1)
+  if(__sync_lock_test_and_set(&lk->locked, 1) != 0){
+    uint64 t0 = getCycles();
+    while(__sync_lock_test_and_set(&lk->locked, 1) != 0)
+      ;
+    spun(lc, t0);
+  }
+}
+
+// Take a ticket (amoadd) and wait until it is served.
+static void
+ticket_acquire(struct spinlock *lk, struct lockcount *lc)
+{
+  uint t = __atomic_fetch_add(&lk->next, 1, __ATOMIC_RELAXED);
+
+  if(__atomic_load_n(&lk->owner, __ATOMIC_ACQUIRE) != t){
+    uint64 t0 = getCycles();
+    while(__atomic_load_n(&lk->owner, __ATOMIC_ACQUIRE) != t)
+      ;
+    spun(lc, t0);
+  }
+  lk->locked = 1;
+}
+
+// Join the tail of the queue (amoswap) with one of this CPU's
+// nodes, and if there was a holder wait for it to hand over.
+static void
+mcs_acquire(struct spinlock *lk, struct lockcount *lc)
+{
+  struct cpu *c = mycpu();
+  struct mcsnode *n, *prev;
+  int i;
+
+  for(i = 0; i < NMCS && (c->mcsused & (1 << i)); i++)
+    ;
+  if(i == NMCS)
+    panic("acquire: out of mcs nodes");
+  c->mcsused |= 1 << i;
+  n = &c->mcs[i];
+  n->next = 0;
+  n->locked = 1;
+
+  prev = __atomic_exchange_n(&lk->tail, n, __ATOMIC_ACQ_REL);
+  if(prev){
+    uint64 t0 = getCycles();
+    __atomic_store_n(&prev->next, n, __ATOMIC_RELEASE);
+    while(__atomic_load_n(&n->locked, __ATOMIC_ACQUIRE))
+      ;
+    spun(lc, t0);
+  }
+  lk->node = n;
+  lk->locked = 1;
+}
+
+// Hand the lock to the next node in the queue, or empty it.
+static void
+mcs_release(struct spinlock *lk)
+{
+  struct cpu *c = mycpu();
+  struct mcsnode *n = lk->node, *next;
+
+  if(n < c->mcs || n >= &c->mcs[NMCS])
+    panic("release: mcs node");
+  lk->locked = 0;
+  next = __atomic_load_n(&n->next, __ATOMIC_ACQUIRE);
+  if(next == 0){
+    struct mcsnode *expect = n;
+    if(__atomic_compare_exchange_n(&lk->tail, &expect, 0, 0,
+                                   __ATOMIC_RELEASE, __ATOMIC_RELAXED)){
+      c->mcsused &= ~(1 << (n - c->mcs));
+      return;
+    }
+    // a waiter has joined the queue but not yet linked in.
+    while((next = __atomic_load_n(&n->next, __ATOMIC_ACQUIRE)) == 0)
+      ;
+  }
+  __atomic_store_n(&next->locked, 0, __ATOMIC_RELEASE);
+  c->mcsused &= ~(1 << (n - c->mcs));
 }
 
 // Acquire the lock.
@@ -21,16 +178,24 @@ initlock(struct spinlock *lk, char *name)
 void
 acquire(struct spinlock *lk)
 {
+  struct lockcount *lc;
+
   push_off(); // disable interrupts to avoid deadlock.
   if(holding(lk))
     panic("acquire");
+  lc = &lockcounts[cpuid()][lk->class];
 
-  // On RISC-V, sync_lock_test_and_set turns into an atomic swap:
-  //   a5 = 1
-  //   s1 = &lk->locked
-  //   amoswap.w.aq a5, a5, (s1)
-  while(__sync_lock_test_and_set(&lk->locked, 1) != 0)
-    ;
+  switch(lk->kind){
+  case LOCK_TICKET:
+    ticket_acquire(lk, lc);
+    break;
+  case LOCK_MCS:
+    mcs_acquire(lk, lc);
+    break;
+  default:
+    tas_acquire(lk, lc);
+    break;
+  }
 
   // Tell the C compiler and the processor to not move loads or stores
   // past this point, to ensure that the critical section's memory
@@ -40,6 +205,8 @@ acquire(struct spinlock *lk)
 
   // Record info about lock acquisition for holding() and debugging.
   lk->cpu = mycpu();
+  lc->nacquire++;
+  lk->tacquire = getCycles();
 }
 
 // Release the lock.
@@ -49,6 +216,11 @@ release(struct spinlock *lk)
   if(!holding(lk))
     panic("release");
 
+  struct lockcount *lc = &lockcounts[cpuid()][lk->class];
+  uint64 hold = getCycles() - lk->tacquire;
+  if(hold > lc->maxhold)
+    lc->maxhold = hold;
+
   lk->cpu = 0;
 
   // Tell the C compiler and the CPU to not move loads or stores
@@ -59,14 +231,26 @@ release(struct spinlock *lk)
   // On RISC-V, this emits a fence instruction.
   __sync_synchronize();
 
-  // Release the lock, equivalent to lk->locked = 0.
-  // This code doesn't use a C assignment, since the C standard
-  // implies that an assignment might be implemented with
-  // multiple store instructions.
-  // On RISC-V, sync_lock_release turns into an atomic swap:
-  //   s1 = &lk->locked
-  //   amoswap.w zero, zero, (s1)
-  __sync_lock_release(&lk->locked);
+  switch(lk->kind){
+  case LOCK_TICKET:
+    // serve the next ticket; only the holder writes owner.
+    lk->locked = 0;
+    __atomic_store_n(&lk->owner, lk->owner + 1, __ATOMIC_RELEASE);
+    break;
+  case LOCK_MCS:
+    mcs_release(lk);
+    break;
+  default:
+    // Release the lock, equivalent to lk->locked = 0.
+    // This code doesn't use a C assignment, since the C standard
+    // implies that an assignment might be implemented with
+    // multiple store instructions.
+    // On RISC-V, sync_lock_release turns into an atomic swap:
+    //   s1 = &lk->locked
+    //   amoswap.w zero, zero, (s1)
+    __sync_lock_release(&lk->locked);
+    break;
+  }
 
   pop_off();
 }
@@ -111,3 +295,117 @@ pop_off(void)
   if(c->noff == 0 && c->intena)
     intr_on();
 }
+
+// The statistics class of locks named name, for lock types
+// built outside this file (see rwlock.c).
+int
+lockstat_class(char *name)
+{
+  return lockclass(name);
+}
+
+// Count an acquisition of a lock of class cls that spun from
+// cycle t0, or took it at once if t0 is 0. Interrupts must be off.
+void
+lockstat_acquire(int cls, uint64 t0)
+{
+  struct lockcount *lc = &lockcounts[cpuid()][cls];
+
+  lc->nacquire++;
+  if(t0)
+    spun(lc, t0);
+}
+
+// Count an acquiresleep() of the sleeplock whose spinlock is lk,
+// which spun or slept and took wait units of the 10MHz clock in
+// all. A waiter that slept may wake on another CPU, so the time
+// comes from the shared clock rather than the per-hart cycle counter.
+void
+lockstat_sleep(struct spinlock *lk, int spun, int slept, uint64 wait)
+{
+  push_off();
+  struct lockcount *lc = &lockcounts[cpuid()][lk->class];
+  lc->nsleepacq++;
+  lc->nspun += spun;
+  lc->nslept += slept;
+  lc->wait += wait;
+  pop_off();
+}
+
+// Copy the statistics of up to n lock classes, most contended
+// first, to user address addr. Returns the number copied.
+int
+klockstat(uint64 addr, int n)
+{
+  char done[NLOCKCLASS];
+  struct lockstat st;
+  int got = 0;
+
+  memset(done, 0, sizeof(done));
+  for(; got < n; got++){
+    int best = -1;
+    uint64 bestc = 0;
+    for(int i = 0; i < nclass; i++){
+      uint64 c = 0;
+      if(done[i])
+        continue;
+      for(int j = 0; j < NCPU; j++)
+        c += lockcounts[j][i].ncontended;
+      if(best < 0 || c > bestc){
+        best = i;
+        bestc = c;
+      }
+    }
+    if(best < 0)
+      break;
+    done[best] = 1;
+
+    memset(&st, 0, sizeof(st));
+    safestrcpy(st.name, classname[best], sizeof(st.name));
+    for(int j = 0; j < NCPU; j++){
+      struct lockcount *lc = &lockcounts[j][best];
+      st.nacquire += lc->nacquire;
+      st.ncontended += lc->ncontended;
+      st.spin += lc->spin;
+      if(lc->maxhold > st.maxhold)
+        st.maxhold = lc->maxhold;
+      st.nsleepacq += lc->nsleepacq;
+      st.nspun += lc->nspun;
+      st.nslept += lc->nslept;
+      st.wait += lc->wait;
+    }
+    if(copyout(myproc()->pagetable, addr + got * sizeof(st), (char *)&st, sizeof(st)) < 0)
+      return -1;
+  }
+  return got;
+}
+
+// One lock of each kind for lockbench(), and the data they guard.
+static struct spinlock benchlock[3];
+static uint64 benchdata[8];
+
+void
+lockbenchinit(void)
+{
+  initlock_kind(&benchlock[LOCK_TAS], "bench-tas", LOCK_TAS);
+  initlock_kind(&benchlock[LOCK_TICKET], "bench-ticket", LOCK_TICKET);
+  initlock_kind(&benchlock[LOCK_MCS], "bench-mcs", LOCK_MCS);
+}
+
+// Take the benchmark lock of kind iters times, doing work
+// updates of the shared data while holding it. Returns -1 if
+// iters or work is out of range.
+int
+klockbench(int kind, int iters, int work)
+{
+  if(kind < LOCK_TAS || kind > LOCK_MCS || iters < 0 || iters > LOCKBENCH_MAXITERS ||
+     work < 0 || work > LOCKBENCH_MAXWORK)
+    return -1;
+  for(int i = 0; i < iters; i++){
+    acquire(&benchlock[kind]);
+    for(int j = 0; j < work; j++)
+      benchdata[j % NELEM(benchdata)]++;
+    release(&benchlock[kind]);
+  }
+  return 0;
+}
@@ -1,3 +1,18 @@
+// Kinds of spin lock (see initlock_kind()).
+#define LOCK_TAS     0   // test-and-set: cheapest, but unfair
+#define LOCK_TICKET  1   // FIFO by ticket; waiters spin on one word
+#define LOCK_MCS     2   // FIFO queue; each waiter spins on its own node
+
+// Kind of the hot kmem and bcache locks; make HOTLOCK=TAS etc.
+#ifndef HOTLOCK
+#define HOTLOCK LOCK_TICKET
+#endif
+
+// Largest lockbench() arguments: the loop runs in the kernel
+// without yielding, so they bound how long one call keeps its CPU.
+#define LOCKBENCH_MAXITERS 100000
+#define LOCKBENCH_MAXWORK  100
+
 // Mutual exclusion lock.
 struct spinlock {
   uint locked;       // Is the lock held?
@@ -5,5 +20,15 @@ struct spinlock {
   // For debugging:
   char *name;        // Name of lock.
   struct cpu *cpu;   // The cpu holding the lock.
-};
 
+  // For the queued kinds:
+  int kind;              // LOCK_*
+  uint next;             // LOCK_TICKET: next ticket to hand out.
+  uint owner;            // LOCK_TICKET: ticket being served.
+  struct mcsnode *tail;  // LOCK_MCS: last in the queue, or 0.
+  struct mcsnode *node;  // LOCK_MCS: the holder's queue node.
+
+  // For lock statistics (see getlockstat()):
+  int class;         // Index of name in the lock class table.
+  uint64 tacquire;   // Cycle counter when acquired.
+};
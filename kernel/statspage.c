@@ -0,0 +1,105 @@
+//
+// Read-only scheduler statistics page.
+//
+// One physical page, rewritten by CPU 0 on every timer tick,
+// that any process can map at SCHEDSTATS with mapstats().
+// Monitors then sample process and CPU load with plain loads:
+// no system calls and no kernel locks. The page is shared by
+// all processes that map it, and is never freed.
+//
+
+#include "types.h"
+#include "param.h"
+#include "memlayout.h"
+#include "riscv.h"
+#include "spinlock.h"
+#include "proc.h"
+#include "statspage.h"
+#include "defs.h"
+
+_Static_assert(sizeof(struct statspage) <= PGSIZE, "statspage too big");
+
+extern struct proc proc[NPROC];
+
+static struct statspage *statspage;
+
+void
+statspageinit(void)
+{
+  if((statspage = (struct statspage *)kalloc()) == 0)
+    panic("statspageinit");
+  memset(statspage, 0, PGSIZE);
+}
+
+// Rewrite the page. Only CPU 0's clock interrupt calls this,
+// so there is a single writer and seq needs no lock.
+void
+statspage_update(void)
+{
+  struct statspage *sp = statspage;
+  struct proc *p;
+  int i, n = 0;
+
+  sp->seq++;
+  __sync_synchronize();
+
+  sp->time = getTime();
+  for(i = 0; i < NPROC; i++){
+    struct statsproc *s = &sp->proc[i];
+    p = &proc[i];
+    acquire(&p->lock);
+    if(p->state == UNUSED){
+      s->pid = 0;
+    } else {
+      s->pid = p->pid;
+      s->state = p->state;
+      s->queue_level = p->queue_level;
+      s->priority = p->priority;
+      s->rtime = p->rtime;
+      safestrcpy(s->name, p->name, sizeof(s->name));
+      if(p->state == RUNNABLE)
+        n++;
+    }
+    release(&p->lock);
+  }
+  sp->nrunnable = n;
+
+  for(i = 0; i < NCPU; i++){
+    struct cpu *c = &cpus[i];
+    struct proc *cp = c->proc;
+    sp->cpu[i].pid = cp ? cp->pid : 0;
+    sp->cpu[i].busy = c->stats.busy;
+    sp->cpu[i].idle = c->stats.idle;
+    sp->cpu[i].sched = c->stats.sched;
+    sp->cpu[i].nswitch = c->stats.nswitch;
+  }
+
+  __sync_synchronize();
+  sp->seq++;
+}
+
+// Is the statistics page mapped in pagetable?
+int
+statsmapped(pagetable_t pagetable)
+{
+  return ismapped(pagetable, SCHEDSTATS);
+}
+
+// Map the statistics page, read-only, into pagetable.
+int
+mapstats(pagetable_t pagetable)
+{
+  return mappages(pagetable, SCHEDSTATS, PGSIZE, (uint64)statspage, PTE_R | PTE_U);
+}
+
+// Map the page into the current process if it isn't already,
+// and return its user address.
+uint64
+kmapstats(void)
+{
+  struct proc *p = myproc();
+
+  if(!statsmapped(p->pagetable) && mapstats(p->pagetable) < 0)
+    return -1;
+  return SCHEDSTATS;
+}
@@ -0,0 +1,36 @@
+// Layout of the read-only scheduler statistics page that
+// mapstats() maps into a process. The kernel rewrites it on
+// every timer tick; readers use seq as a seqlock: it is odd
+// while an update is in progress, so a copy taken between two
+// equal, even reads of seq is consistent.
+// Needs param.h for NPROC and NCPU.
+
+#ifndef STATSPAGE_H
+#define STATSPAGE_H
+
+struct statsproc {
+  int pid;              // 0 if the slot is unused
+  int state;            // enum procstate
+  int queue_level;      // MLFQ level
+  int priority;         // nice value
+  uint64 rtime;         // CPU time so far (10MHz clock)
+  char name[16];
+};
+
+struct statscpu {
+  int pid;              // process running on this CPU, or 0
+  uint64 busy;          // cycles running processes (see struct cpustats)
+  uint64 idle;
+  uint64 sched;
+  uint64 nswitch;
+};
+
+struct statspage {
+  volatile uint seq;
+  uint64 time;          // when the page was last updated (10MHz clock)
+  int nrunnable;        // RUNNABLE processes at that time
+  struct statsproc proc[NPROC];
+  struct statscpu cpu[NCPU];
+};
+
+#endif // STATSPAGE_H
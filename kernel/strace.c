@@ -0,0 +1,213 @@
+//
+// System call statistics and tracing.
+//
+// With SCHEDCTL_SYSTIME on, syscall() times each call with the
+// 10MHz clock and adds its latency to a log2 histogram for its
+// number on the CPU it returned on, and to the calling process's
+// count and total for that number; getsysstat(0, ...) sums the
+// CPUs. Full histograms of one process would be too big to keep
+// for every process.
+//
+// With SCHEDCTL_STRACE set to a pid, syscall() also logs each
+// call that process makes, with its arguments, return value and
+// latency, in a ring buffer that getstrace() drains, and adds
+// the latency to that process's own histograms, kept until
+// another process is traced. A full buffer overwrites its
+// oldest entry. exit() does not return, so it is logged on entry.
+//
+
+#include "types.h"
+#include "param.h"
+#include "memlayout.h"
+#include "riscv.h"
+#include "spinlock.h"
+#include "proc.h"
+#include "syscall.h"
+#include "procinfo.h"
+#include "defs.h"
+
+#define NSTRACE 256
+
+int systime_on;             // time every system call?
+int strace_pid;             // trace this process's calls; 0 = none
+
+// written with interrupts off.
+static struct hist cpulat[NCPU][NSYSCALL];
+
+static struct {
+  struct spinlock lock;
+  int head;                 // oldest entry
+  int n;
+  uint64 ndropped;          // entries overwritten before being read
+  struct straceent buf[NSTRACE];
+  int latpid;               // process whose calls are in lat[]
+  struct hist lat[NSYSCALL];
+} strace;
+
+// calls whose first argument is a path.
+static char pathcall[NSYSCALL] = {
+  [SYS_exec] 1, [SYS_chdir] 1, [SYS_open] 1, [SYS_mknod] 1,
+  [SYS_unlink] 1, [SYS_link] 1, [SYS_mkdir] 1,
+};
+
+void
+straceinit(void)
+{
+  initlock(&strace.lock, "strace");
+}
+
+// Trace process pid's calls from now on; 0 stops tracing but
+// keeps the last process's histograms. Returns the old pid.
+int
+strace_set(int pid)
+{
+  int old;
+
+  if(pid < 0)
+    return strace_pid;
+  acquire(&strace.lock);
+  old = strace_pid;
+  strace_pid = pid;
+  if(pid != 0 && pid != strace.latpid){
+    strace.latpid = pid;
+    memset(strace.lat, 0, sizeof(strace.lat));
+  }
+  release(&strace.lock);
+  return old;
+}
+
+// Count call num by p, which took dur. Called only by p.
+void
+sysstat_add(struct proc *p, int num, uint64 dur)
+{
+  p->sysn[num]++;
+  p->systime[num] += dur;
+  push_off();
+  hist_add(&cpulat[cpuid()][num], dur);
+  pop_off();
+}
+
+static void
+strace_log(struct straceent *e)
+{
+  acquire(&strace.lock);
+  if(e->num != SYS_exit && e->pid == strace.latpid)
+    hist_add(&strace.lat[e->num], e->dur);
+  if(strace.n == NSTRACE){
+    strace.head = (strace.head + 1) % NSTRACE;
+    strace.n--;
+    strace.ndropped++;
+  }
+  strace.buf[(strace.head + strace.n++) % NSTRACE] = *e;
+  release(&strace.lock);
+}
+
+// Record the arguments of call num by p, before it runs.
+void
+strace_enter(struct straceent *e, struct proc *p, int num)
+{
+  struct trapframe *tf = p->trapframe;
+
+  memset(e, 0, sizeof(*e));
+  e->pid = p->pid;
+  e->num = num;
+  e->arg[0] = tf->a0;
+  e->arg[1] = tf->a1;
+  e->arg[2] = tf->a2;
+  e->arg[3] = tf->a3;
+  e->arg[4] = tf->a4;
+  e->arg[5] = tf->a5;
+  if(pathcall[num] && fetchstr(tf->a0, e->str, sizeof(e->str)) < 0)
+    e->str[0] = 0;
+  if(num == SYS_exit){
+    e->time = getTime();
+    strace_log(e);
+  }
+}
+
+// Finish and log the entry of a call that returned ret.
+void
+strace_exit(struct straceent *e, uint64 ret, uint64 dur)
+{
+  e->time = getTime();
+  e->ret = ret;
+  e->dur = dur;
+  strace_log(e);
+}
+
+// Copy the latency histograms of every system call of process
+// pid, or of all processes if pid is 0, to user address addr,
+// NSYSCALL of them indexed by call number. Only the traced (or
+// last traced) process has full histograms; for any other, just
+// count and sum are filled in.
+int
+ksysstat(int pid, uint64 addr)
+{
+  struct proc *p = 0;
+  struct hist h;
+
+  if(pid < 0)
+    return -1;
+  if(pid > 0 && pid != strace.latpid && (p = getproc(pid)) == 0)
+    return -1;
+  for(int num = 0; num < NSYSCALL; num++){
+    if(p){
+      memset(&h, 0, sizeof(h));
+      acquire(&p->lock);
+      if(p->pid != pid){
+        release(&p->lock);
+        return -1;
+      }
+      h.count = p->sysn[num];
+      h.sum = p->systime[num];
+      release(&p->lock);
+    } else if(pid){
+      acquire(&strace.lock);
+      if(pid != strace.latpid){
+        release(&strace.lock);
+        return -1;
+      }
+      h = strace.lat[num];
+      release(&strace.lock);
+    } else {
+      memset(&h, 0, sizeof(h));
+      for(int i = 0; i < NCPU; i++)
+        hist_merge(&h, &cpulat[i][num]);
+    }
+    if(copyout(myproc()->pagetable, addr + num * sizeof(h), (char *)&h, sizeof(h)) < 0)
+      return -1;
+  }
+  return 0;
+}
+
+// Copy up to n trace entries, oldest first, to user address
+// addr, removing them from the buffer. Returns the number copied.
+int
+kgetstrace(uint64 addr, int n)
+{
+  struct straceent e;
+  int got = 0;
+
+  while(got < n){
+    acquire(&strace.lock);
+    if(strace.n == 0){
+      release(&strace.lock);
+      break;
+    }
+    e = strace.buf[strace.head];
+    strace.head = (strace.head + 1) % NSTRACE;
+    strace.n--;
+    release(&strace.lock);
+    if(copyout(myproc()->pagetable, addr + got * sizeof(e), (char *)&e, sizeof(e)) < 0)
+      return -1;
+    got++;
+  }
+  return got;
+}
+
+// Trace entries lost so far to a full buffer.
+uint64
+strace_dropped(void)
+{
+  return strace.ndropped;
+}
@@ -5,6 +5,7 @@
 #include "spinlock.h"
 #include "proc.h"
 #include "syscall.h"
+#include "procinfo.h"
 #include "defs.h"
 
 // Fetch the uint64 at addr from the current process.
@@ -105,6 +106,28 @@ extern uint64 sys_setexpected(void);
 extern uint64 sys_setstcfvals(void);
 extern uint64 sys_yield(void);
 extern uint64 sys_getprocinfo(void);
+extern uint64 sys_yield_to(void);
+extern uint64 sys_send(void);
+extern uint64 sys_recv(void);
+extern uint64 sys_nice(void);
+extern uint64 sys_setpriority(void);
+extern uint64 sys_getpriority(void);
+extern uint64 sys_schedctl(void);
+extern uint64 sys_setpgid(void);
+extern uint64 sys_setquota(void);
+extern uint64 sys_getpgroupinfo(void);
+extern uint64 sys_getwaithist(void);
+extern uint64 sys_waitx(void);
+extern uint64 sys_exitstats(void);
+extern uint64 sys_getcpustats(void);
+extern uint64 sys_mapstats(void);
+extern uint64 sys_gettime(void);
+extern uint64 sys_nanosleep(void);
+extern uint64 sys_getprofile(void);
+extern uint64 sys_getsysstat(void);
+extern uint64 sys_getstrace(void);
+extern uint64 sys_getlockstat(void);
+extern uint64 sys_lockbench(void);
 
 // An array mapping syscall numbers from syscall.h
 // to the function that handles the system call.
@@ -134,6 +157,28 @@ static uint64 (*syscalls[])(void) = {
     [SYS_setstcfvals] sys_setstcfvals,
     [SYS_yield] sys_yield,
     [SYS_getprocinfo] sys_getprocinfo,
+    [SYS_yield_to] sys_yield_to,
+    [SYS_send] sys_send,
+    [SYS_recv] sys_recv,
+    [SYS_nice] sys_nice,
+    [SYS_setpriority] sys_setpriority,
+    [SYS_getpriority] sys_getpriority,
+    [SYS_schedctl] sys_schedctl,
+    [SYS_setpgid] sys_setpgid,
+    [SYS_setquota] sys_setquota,
+    [SYS_getpgroupinfo] sys_getpgroupinfo,
+    [SYS_getwaithist] sys_getwaithist,
+    [SYS_waitx] sys_waitx,
+    [SYS_exitstats] sys_exitstats,
+    [SYS_getcpustats] sys_getcpustats,
+    [SYS_mapstats] sys_mapstats,
+    [SYS_gettime] sys_gettime,
+    [SYS_nanosleep] sys_nanosleep,
+    [SYS_getprofile] sys_getprofile,
+    [SYS_getsysstat] sys_getsysstat,
+    [SYS_getstrace] sys_getstrace,
+    [SYS_getlockstat] sys_getlockstat,
+    [SYS_lockbench] sys_lockbench,
 };
 
 void
@@ -141,12 +186,28 @@ syscall(void)
 {
   int num;
   struct proc *p = myproc();
+  struct straceent e;
 
   num = p->trapframe->a7;
   if(num > 0 && num < NELEM(syscalls) && syscalls[num]) {
+    // time and trace the call if asked to (see strace.c).
+    int traced = strace_pid != 0 && p->pid == strace_pid;
+    int timed = systime_on || traced;
+    uint64 t0 = 0;
+    if(traced)
+      strace_enter(&e, p, num);
+    if(timed)
+      t0 = getTime();
     // Use num to lookup the system call function for num, call it,
     // and store its return value in p->trapframe->a0
     p->trapframe->a0 = syscalls[num]();
+    if(timed){
+      uint64 dur = getTime() - t0;
+      if(systime_on)
+        sysstat_add(p, num, dur);
+      if(traced)
+        strace_exit(&e, p->trapframe->a0, dur);
+    }
   } else {
     printf("%d %s: unknown sys call %d\n",
             p->pid, p->name, num);
@@ -28,3 +28,47 @@
 
 // NOTE: for evaluation
 #define SYS_getprocinfo 25
+
+// directed yield and rendezvous IPC
+#define SYS_yield_to 26
+#define SYS_send 27
+#define SYS_recv 28
+
+// nice values
+#define SYS_nice 29
+#define SYS_setpriority 30
+#define SYS_getpriority 31
+
+// scheduler tunables (see schedctl.h)
+#define SYS_schedctl 32
+
+// process group CPU quotas
+#define SYS_setpgid 33
+#define SYS_setquota 34
+#define SYS_getpgroupinfo 35
+
+// run-queue latency
+#define SYS_getwaithist 36
+
+// wait() with the child's final timing
+#define SYS_waitx 37
+
+// scheduler statistics
+#define SYS_exitstats 38
+#define SYS_getcpustats 39
+#define SYS_mapstats 40
+
+// clock and timers
+#define SYS_gettime 41
+#define SYS_nanosleep 42
+
+// profiling and tracing
+#define SYS_getprofile 43
+#define SYS_getsysstat 44
+#define SYS_getstrace 45
+
+// lock statistics and benchmarks
+#define SYS_getlockstat 46
+#define SYS_lockbench 47
+
+#define NSYSCALL 48   // one more than the largest number above
@@ -314,6 +314,17 @@ sys_open(void)
   if((n = argstr(0, path, MAXPATH)) < 0)
     return -1;
 
+  // /proc is generated by the kernel, not stored on disk.
+  if(procfs_match(path)){
+    if(omode != O_RDONLY || (f = procfs_open(path)) == 0)
+      return -1;
+    if((fd = fdalloc(f)) < 0){
+      fileclose(f);
+      return -1;
+    }
+    return fd;
+  }
+
   begin_op();
 
   if(omode & O_CREATE){
@@ -7,6 +7,7 @@
 #include "proc.h"
 #include "procinfo.h"
 #include "vm.h"
+#include "schedpolicy.h"
 
 uint64
 sys_exit(void)
@@ -34,7 +35,16 @@ sys_wait(void)
 {
   uint64 p;
   argaddr(0, &p);
-  return kwait(p);
+  return kwait(p, 0);
+}
+
+uint64
+sys_waitx(void)
+{
+  uint64 p, info;
+  argaddr(0, &p);
+  argaddr(1, &info);
+  return kwait(p, info);
 }
 
 uint64
@@ -58,7 +68,7 @@ sys_sbrk(void)
     // memory, vmfault() will allocate it.
     if(addr + n < addr)
       return -1;
-    if(addr + n > TRAPFRAME)
+    if(addr + n > USERTOP)
       return -1;
     myproc()->sz += n;
   }
@@ -109,6 +119,78 @@ sys_uptime(void)
   return xticks;
 }
 
+// return the 10MHz clock, for timing finer than a tick.
+uint64
+sys_gettime(void)
+{
+  return getTime();
+}
+
+// sleep for a number of 10MHz clock units.
+uint64
+sys_nanosleep(void)
+{
+  uint64 dur;
+
+  argaddr(0, &dur);
+  return knanosleep(dur);
+}
+
+uint64
+sys_getprofile(void)
+{
+  uint64 addr;
+  int n;
+
+  argaddr(0, &addr);
+  argint(1, &n);
+  return kgetprofile(addr, n);
+}
+
+uint64
+sys_getsysstat(void)
+{
+  int pid;
+  uint64 addr;
+
+  argint(0, &pid);
+  argaddr(1, &addr);
+  return ksysstat(pid, addr);
+}
+
+uint64
+sys_getstrace(void)
+{
+  uint64 addr;
+  int n;
+
+  argaddr(0, &addr);
+  argint(1, &n);
+  return kgetstrace(addr, n);
+}
+
+uint64
+sys_getlockstat(void)
+{
+  uint64 addr;
+  int n;
+
+  argaddr(0, &addr);
+  argint(1, &n);
+  return klockstat(addr, n);
+}
+
+uint64
+sys_lockbench(void)
+{
+  int kind, iters, work;
+
+  argint(0, &kind);
+  argint(1, &iters);
+  argint(2, &work);
+  return klockbench(kind, iters, work);
+}
+
 uint64
 sys_setexpected(void)
 {
@@ -140,7 +222,7 @@ sys_setstcfvals(void)
 
   acquire(&p->lock);
   p->expected_runtime = (uint64)expected;
-  p->time_left = (uint64)expected + 1;
+  p->time_left = stcf_time_left((uint64)expected);
   release(&p->lock);
 
   //printf("sys_setstcfvals called with %d\n", expected);
@@ -156,6 +238,161 @@ sys_yield(void)
   return 0;
 }
 
+// Give the CPU directly to another process.
+uint64
+sys_yield_to(void)
+{
+  int pid;
+
+  argint(0, &pid);
+  return kyield_to(pid);
+}
+
+uint64
+sys_send(void)
+{
+  int pid, n;
+  uint64 msg;
+
+  argint(0, &pid);
+  argaddr(1, &msg);
+  argint(2, &n);
+  return ksend(pid, msg, n);
+}
+
+uint64
+sys_recv(void)
+{
+  uint64 pid, buf;
+  int n;
+
+  argaddr(0, &pid);
+  argaddr(1, &buf);
+  argint(2, &n);
+  return krecv(pid, buf, n);
+}
+
+// Add inc to the caller's nice value; returns the new value.
+uint64
+sys_nice(void)
+{
+  int inc;
+
+  argint(0, &inc);
+  if(inc > NICE_MAX - NICE_MIN)
+    inc = NICE_MAX - NICE_MIN;
+  if(inc < NICE_MIN - NICE_MAX)
+    inc = NICE_MIN - NICE_MAX;
+  ksetpriority(0, kgetpriority(0) + inc);
+  return kgetpriority(0);
+}
+
+uint64
+sys_setpriority(void)
+{
+  int pid, nice;
+
+  argint(0, &pid);
+  argint(1, &nice);
+  return ksetpriority(pid, nice);
+}
+
+uint64
+sys_getpriority(void)
+{
+  int pid;
+
+  argint(0, &pid);
+  return kgetpriority(pid);
+}
+
+// Read and optionally set a scheduler tunable.
+uint64
+sys_schedctl(void)
+{
+  int param, val;
+
+  argint(0, &param);
+  argint(1, &val);
+  return kschedctl(param, val);
+}
+
+uint64
+sys_setpgid(void)
+{
+  int pid, pgid;
+
+  argint(0, &pid);
+  argint(1, &pgid);
+  return ksetpgid(pid, pgid);
+}
+
+// Limit process group pgid to quota units of CPU time
+// (10MHz clock) every period; a quota of 0 removes the limit.
+uint64
+sys_setquota(void)
+{
+  int pgid, quota, period;
+
+  argint(0, &pgid);
+  argint(1, &quota);
+  argint(2, &period);
+  if(quota < 0 || period < 0)
+    return -1;
+  return ksetquota(pgid, quota, period);
+}
+
+uint64
+sys_getpgroupinfo(void)
+{
+  int pgid;
+  uint64 addr;
+
+  argint(0, &pgid);
+  argaddr(1, &addr);
+  return kgetpgroupinfo(pgid, addr);
+}
+
+uint64
+sys_exitstats(void)
+{
+  uint64 addr;
+  int reset;
+
+  argaddr(0, &addr);
+  argint(1, &reset);
+  return kexitstats(addr, reset);
+}
+
+uint64
+sys_getcpustats(void)
+{
+  uint64 addr;
+  int n;
+
+  argaddr(0, &addr);
+  argint(1, &n);
+  return kgetcpustats(addr, n);
+}
+
+uint64
+sys_mapstats(void)
+{
+  return kmapstats();
+}
+
+uint64
+sys_getwaithist(void)
+{
+  int kind, id;
+  uint64 addr;
+
+  argint(0, &kind);
+  argint(1, &id);
+  argaddr(2, &addr);
+  return kgetwaithist(kind, id, addr);
+}
+
 // Need this to get procinfo from kernel side to user side 
 uint64
 sys_getprocinfo(void)
@@ -171,20 +408,11 @@ sys_getprocinfo(void)
     return -1;
 
   acquire(&p->lock);
-  info.pid = p->pid;
-  info.state = p->state;
-  info.ctime = p->ctime;
-  info.etime = p->etime;
-  info.rtime = p->rtime;
-  info.stime = p->stime;
-  
-  info.expected_runtime = p->expected_runtime;
-  info.time_left = p->time_left;
-  info.priority = p->priority;
-  info.queue_level = p->queue_level;
-  info.time_slice = p->time_slice;
-  safestrcpy(info.name, p->name, sizeof(info.name));
-
+  if(p->pid != pid){
+    release(&p->lock);
+    return -1;
+  }
+  fillprocinfo(p, &info);
   release(&p->lock);
 
   // copy struct to user space
@@ -0,0 +1,161 @@
+//
+// High-resolution sleeps.
+//
+// knanosleep() puts the caller's deadline in its CPU's timer
+// queue, a min-heap ordered by deadline, and programs stimecmp
+// for whichever comes first: the earliest deadline or the next
+// scheduler tick. clockintr() calls timer_expire() to wake the
+// sleepers whose deadlines have passed, so each wakes once, as
+// soon as its time is up, instead of on every tick.
+//
+// A sleeper sleeps on &p->deadline with its queue's lock as the
+// condition lock. That CPU's clock interrupt pops entries as they
+// expire; a sleeper that leaves before that (killed, or its
+// deadline passed first) removes its own.
+//
+
+#include "types.h"
+#include "param.h"
+#include "memlayout.h"
+#include "riscv.h"
+#include "spinlock.h"
+#include "proc.h"
+#include "defs.h"
+
+void
+timerqinit(void)
+{
+  for(struct cpu *c = cpus; c < &cpus[NCPU]; c++)
+    initlock(&c->timers.lock, "timerq");
+}
+
+static void
+swap(struct timerq *q, int i, int j)
+{
+  struct timer t = q->heap[i];
+  q->heap[i] = q->heap[j];
+  q->heap[j] = t;
+}
+
+static void
+siftup(struct timerq *q, int i)
+{
+  while(i > 0 && q->heap[i].deadline < q->heap[(i - 1) / 2].deadline){
+    swap(q, i, (i - 1) / 2);
+    i = (i - 1) / 2;
+  }
+}
+
+static void
+siftdown(struct timerq *q, int i)
+{
+  for(;;){
+    int l = 2 * i + 1, r = l + 1, m = i;
+    if(l < q->n && q->heap[l].deadline < q->heap[m].deadline)
+      m = l;
+    if(r < q->n && q->heap[r].deadline < q->heap[m].deadline)
+      m = r;
+    if(m == i)
+      return;
+    swap(q, i, m);
+    i = m;
+  }
+}
+
+// Remove heap entry i. Caller must hold q->lock.
+static void
+timer_remove(struct timerq *q, int i)
+{
+  q->heap[i] = q->heap[--q->n];
+  if(i < q->n){
+    siftup(q, i);
+    siftdown(q, i);
+  }
+}
+
+// Remove p's entry, if it is still in q. Caller must hold q->lock.
+static void
+timer_cancel(struct timerq *q, struct proc *p)
+{
+  for(int i = 0; i < q->n; i++){
+    if(q->heap[i].p == p){
+      timer_remove(q, i);
+      return;
+    }
+  }
+}
+
+// Set this CPU's stimecmp to its next tick, profiler sample
+// or earliest deadline. Interrupts must be off.
+void
+timer_program(struct cpu *c)
+{
+  uint64 next = c->next_tick;
+
+  if(prof_interval && c->next_prof < next)
+    next = c->next_prof;
+  if(c->timers.n > 0 && c->timers.heap[0].deadline < next)
+    next = c->timers.heap[0].deadline;
+  w_stimecmp(next);
+}
+
+// Wake the sleepers on this CPU whose deadlines have passed.
+// Called from clockintr() with interrupts off.
+void
+timer_expire(struct cpu *c, uint64 now)
+{
+  struct timerq *q = &c->timers;
+
+  acquire(&q->lock);
+  while(q->n > 0 && q->heap[0].deadline <= now){
+    struct proc *p = q->heap[0].p;
+    timer_remove(q, 0);
+    acquire(&p->lock);
+    wakeupproc(p, &p->deadline);
+    release(&p->lock);
+  }
+  release(&q->lock);
+}
+
+// Sleep for dur units of the 10MHz clock. A dur too long for
+// the clock sleeps until killed.
+// Returns -1 if killed.
+int
+knanosleep(uint64 dur)
+{
+  struct proc *p = myproc();
+  struct timerq *q;
+  struct cpu *c;
+  int r = 0;
+  uint64 now;
+
+  if(dur == 0)
+    return 0;
+
+  // interrupts stay off from here until the sleep, and
+  // so does this CPU.
+  push_off();
+  c = mycpu();
+  q = &c->timers;
+  acquire(&q->lock);
+  pop_off();
+
+  now = getTime();
+  p->deadline = dur < ~0ULL - now ? now + dur : ~0ULL;
+  q->heap[q->n].deadline = p->deadline;
+  q->heap[q->n].p = p;
+  siftup(q, q->n++);
+  timer_program(c);
+
+  while(getTime() < p->deadline){
+    if(killed(p)){
+      r = -1;
+      break;
+    }
+    sleep(&p->deadline, &q->lock);
+  }
+  // gone already if timer_expire() woke us.
+  timer_cancel(q, p);
+  release(&q->lock);
+  return r;
+}
@@ -27,6 +27,10 @@ void
 trapinithart(void)
 {
   w_stvec((uint64)kernelvec);
+
+  // let user code read time, cycle and instret itself,
+  // e.g. gettime() in ulib.c.
+  w_scounteren(COUNTEREN_CY | COUNTEREN_TM | COUNTEREN_IR);
 }
 
 //
@@ -47,6 +51,8 @@ usertrap(void)
   w_stvec((uint64)kernelvec);  //DOC: kernelvec
 
   struct proc *p = myproc();
+  acct_trapenter(p);
+  rcu_qs();
   
   // save user program counter.
   p->trapframe->epc = r_sepc();
@@ -80,18 +86,11 @@ usertrap(void)
   if(killed(p))
     kexit(-1);
 
-  // On timer interrupt, account CPU time and maybe preempt.
+  // On timer interrupt, maybe preempt. CPU time is
+  // accounted in run() and acct_trapenter()/acct_trapexit().
   if(which_dev == 2){
-    // p is the current process (may be 0 if something weird, but here it won't be)
-    if (p != 0 && p->state == RUNNING)
-    {
-      acquire(&p->lock);
-      p->rtime++;
-      release(&p->lock);
-      // NOTE: Need to decrement time left for STCF --> scheduling moved to yield()
-    }
-
-    yield();
+    if(timeslice_up(p))
+      preempt();
   }
 
   prepare_return();
@@ -138,6 +137,8 @@ prepare_return(void)
 
   // set S Exception Program Counter to the saved user pc.
   w_sepc(p->trapframe->epc);
+
+  acct_trapexit(p);
 }
 
 // interrupts and exceptions from kernel code go here via kernelvec,
@@ -154,6 +155,7 @@ kerneltrap()
     panic("kerneltrap: not from supervisor mode");
   if(intr_get() != 0)
     panic("kerneltrap: interrupts enabled");
+  rcu_qs();   // interrupts were on, so no RCU reader was interrupted
 
   if((which_dev = devintr()) == 0){
     // interrupt or trap from an unknown source
@@ -163,7 +165,7 @@ kerneltrap()
 
   // give up the CPU if this is a timer interrupt.
   if(which_dev == 2 && myproc() != 0)
-    yield();
+    preempt();
 
   // the yield() may have caused some traps to occur,
   // so restore trap registers for use by kernelvec.S's sepc instruction.
@@ -171,25 +173,44 @@ kerneltrap()
   w_sstatus(sstatus);
 }
 
-void
+// a timer interrupt: a scheduler tick, a nanosleep() deadline,
+// a profiler sample, or several. returns 1 if it was a tick.
+int
 clockintr()
 {
-  if(cpuid() == 0){
-    acquire(&tickslock);
-    ticks++;
-    wakeup(&ticks);
-    release(&tickslock);
+  struct cpu *c = mycpu();
+  uint64 now = r_time();
+  int tick = now >= c->next_tick;
+
+  if(tick){
+    if(cpuid() == 0){
+      acquire(&tickslock);
+      ticks++;
+      wakeup(&ticks);
+      release(&tickslock);
+      starvation_watch();
+      statspage_update();
+      loadavg_tick();
+    }
+    cpustat_tick();
+    // 1000000 is about a tenth of a second.
+    c->next_tick = now + 1000000;
+  }
+  timer_expire(c, now);
+  if(prof_interval && now >= c->next_prof){
+    prof_sample();
+    c->next_prof = now + prof_interval;
   }
 
   // ask for the next timer interrupt. this also clears
-  // the interrupt request. 1000000 is about a tenth
-  // of a second.
-  w_stimecmp(r_time() + 1000000);
+  // the interrupt request.
+  timer_program(c);
+  return tick;
 }
 
 // check if it's an external interrupt or software interrupt,
 // and handle it.
-// returns 2 if timer interrupt,
+// returns 2 if timer tick,
 // 1 if other device,
 // 0 if not recognized.
 int
@@ -219,9 +240,9 @@ devintr()
 
     return 1;
   } else if(scause == 0x8000000000000005L){
-    // timer interrupt.
-    clockintr();
-    return 2;
+    // timer interrupt. only a tick counts against the
+    // running process's time slice.
+    return clockintr() ? 2 : 1;
   } else {
     return 0;
   }
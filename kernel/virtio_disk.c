@@ -282,7 +282,7 @@ virtio_disk_rw(struct buf *b, int write)
 
   // Wait for virtio_disk_intr() to say request has finished.
   while(b->disk == 1) {
-    sleep(b, &disk.vdisk_lock);
+    sleepio(b, &disk.vdisk_lock);
   }
 
   disk.info[idx[0]].b = 0;
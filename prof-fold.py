@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+
+#
+# turn the output of xv6's prof command into folded stacks for
+# flamegraph.pl, symbolizing with kernel/kernel.sym and user/<name>.sym
+#
+# (in xv6) prof -i 2000 schedbench > prof.out, or copy the console log
+# ./prof-fold.py prof.out > prof.folded
+# flamegraph.pl prof.folded > prof.svg
+#
+
+import argparse, bisect, collections, os, sys
+
+parser = argparse.ArgumentParser()
+parser.add_argument('file', nargs='?', help="prof output (default stdin)")
+parser.add_argument("--root", default=os.path.dirname(os.path.abspath(__file__)),
+                    help="xv6 tree with the .sym files")
+args = parser.parse_args()
+
+class Syms:
+    def __init__(self, path):
+        self.addrs, self.names = [], []
+        syms = []
+        with open(path) as f:
+            for line in f:
+                w = line.split()
+                if len(w) != 2 or w[1].startswith('.') or w[1].endswith(('.c', '.S', '.o')):
+                    continue
+                syms.append((int(w[0], 16), w[1]))
+        for a, n in sorted(syms):
+            self.addrs.append(a)
+            self.names.append(n)
+
+    def lookup(self, addr):
+        i = bisect.bisect_right(self.addrs, addr) - 1
+        return self.names[i] if i >= 0 else "0x%x" % addr
+
+ksyms = Syms(os.path.join(args.root, "kernel", "kernel.sym"))
+usyms = {}
+
+def user_syms(name):
+    if name not in usyms:
+        path = os.path.join(args.root, "user", name + ".sym")
+        usyms[name] = Syms(path) if os.path.exists(path) else None
+    return usyms[name]
+
+counts = collections.Counter()
+f = open(args.file) if args.file else sys.stdin
+for line in f:
+    w = line.split()
+    if len(w) < 6 or w[0] != 'P':
+        continue
+    name, mode = w[3], w[4]
+    pc = int(w[5], 16)
+    # return addresses point after the call; ra-1 is in the caller
+    ras = [int(a, 16) - 1 for a in w[6:]]
+    if mode == 'k':
+        # the walk starts in prof_sample(); drop the trap path up
+        # to kernelvec, leaving the interrupted code's callers.
+        frames = [ksyms.lookup(a) for a in ras]
+        if "kernelvec" in frames:
+            frames = frames[frames.index("kernelvec") + 1:]
+        stack = [ksyms.lookup(pc)] + frames
+        stack = [s + "_[k]" for s in stack]
+    else:
+        syms = user_syms(name)
+        look = syms.lookup if syms else (lambda a: "0x%x" % a)
+        stack = [look(pc)] + [look(a) for a in ras]
+    stack.append(name if name != '-' else "scheduler")
+    counts[";".join(reversed(stack))] += 1
+
+for stack, n in sorted(counts.items()):
+    print(stack, n)
@@ -0,0 +1,490 @@
+//
+// Host-side scheduler simulator.
+//
+// Replays workload traces through the policy code in
+// kernel/schedpolicy.c with virtual time, on one simulated CPU,
+// and reports turnaround, response and waiting time and Jain's
+// fairness index of slowdown for each policy. Each policy picks
+// with the same loops as scheduler() in kernel/proc.c (sched_rr()
+// etc. in schedpolicy.c); a timer tick every TICK preempts the
+// running process (after rr_ticks() ticks under RR), and wakeups
+// do not preempt. -t checks the dispatch order of a few small
+// traces against what the kernel does with them.
+//
+// usage: schedsim [-p policy] trace...
+//        schedsim [-p policy] -r ntraces [-s seed]
+//        schedsim -t
+//
+// A trace has one process per line, times in milliseconds:
+//   name arrival nice hint cpu [io cpu]...
+// hint is the expected runtime given to setexpected()/setstcfvals()
+// (0 = none). Lines starting with # are comments. -r replays
+// ntraces random traces instead and averages the results.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "kernel/types.h"
+#include "kernel/schedpolicy.h"
+
+#define MS       10000ULL     // 10MHz clock units per millisecond
+#define TICK     1000000ULL   // timer interrupt interval (kernel/trap.c)
+#define NTASK    64           // NPROC
+#define NBURST   32
+#define LOGSZ    4096
+
+enum policy { RR, FIFO, SJF, STCF, MLFQ, NPOLICY };
+static char *policies[] = { "RR", "FIFO", "SJF", "STCF", "MLFQ" };
+
+enum state { FUTURE, RUNNABLE, SLEEPING, DONE };
+
+struct task {
+  char name[16];
+  int pid;
+  int nice;
+  uint64 arrival;
+  uint64 hint;
+  int nburst;
+  uint64 burst[NBURST];       // cpu, io, cpu, ...
+
+  // simulation state
+  enum state state;
+  int cur;                    // index into burst
+  uint64 left;                // of the current burst
+  uint64 wake;                // when a SLEEPING task wakes
+  uint64 rstart, sleep_start;
+  uint64 stime, etime, ltime, lastoff;
+  uint64 wtime, cputime;
+  uint64 time_left;
+  int level, rr_skip;
+  uint64 slice;
+  uint64 sleep_recent, run_recent;
+};
+
+struct trace {
+  int n;
+  struct task task[NTASK];
+};
+
+struct result {
+  double turnaround, response, waiting;   // means, in ms
+  double maxturnaround;
+  double fairness;                        // Jain's index of slowdown
+};
+
+// ---- the simulated machine ----
+
+// What the shared pick loops in kernel/schedpolicy.c run on:
+// the trace's tasks as the process table, in virtual time.
+struct sim {
+  struct trace *t;
+  enum policy pol;
+  uint64 now;
+  int done;
+  char *log;          // if not 0, the pid of each dispatch is appended
+  int loglen;
+};
+
+static void
+admit(struct sim *s)
+{
+  struct trace *t = s->t;
+
+  for(int i = 0; i < t->n; i++){
+    struct task *p = &t->task[i];
+    if(p->state == FUTURE && p->arrival <= s->now){
+      p->state = RUNNABLE;
+      p->rstart = p->arrival;
+    } else if(p->state == SLEEPING && p->wake <= s->now){
+      uint64 slept = p->wake - p->sleep_start;
+      p->sleep_recent += slept;
+      interact_decay_hist(&p->sleep_recent, &p->run_recent);
+      // the MLFQ I/O boost of wakeproc()
+      if(s->pol == MLFQ)
+        mlfq_wake_boost(&p->level, &p->slice, p->nice,
+                        interact_score(p->sleep_recent, p->run_recent), INTERACT_THRESH);
+      p->state = RUNNABLE;
+      p->rstart = p->wake;
+    }
+  }
+}
+
+static int
+sim_get(void *arg, int i, struct sched_cand *c)
+{
+  struct task *p = &((struct sim *)arg)->t->task[i];
+
+  if(p->state != RUNNABLE)
+    return 0;
+  c->nice = p->nice;
+  c->pid = p->pid;
+  c->ctime = p->arrival;
+  c->expected = p->hint;
+  c->time_left = p->time_left;
+  c->aged = 0;          // SJF/STCF aging is off by default
+  c->level = p->level;
+  c->ltime = p->ltime;
+  c->rr_skip = &p->rr_skip;
+  return 1;
+}
+
+static void
+sim_put(void *arg, int i)
+{
+}
+
+// Run task i until its burst ends or the timer preempts it, as
+// run() and usertrap() do, then admit what arrived meanwhile.
+static void
+sim_run(void *arg, int i)
+{
+  struct sim *s = arg;
+  struct task *p = &s->t->task[i];
+  uint64 now = s->now;
+
+  if(s->log)
+    s->loglen += snprintf(s->log + s->loglen, LOGSZ - s->loglen, "%s%d",
+                          s->loglen ? " " : "", p->pid);
+
+  p->wtime += now - p->rstart;
+  if(p->stime == 0)
+    p->stime = now ? now : 1;
+  p->ltime = now;
+
+  int ticks = s->pol == RR ? rr_ticks(p->nice) : 1;
+  uint64 preempt = (now / TICK + ticks) * TICK;
+  uint64 elapsed = p->left < preempt - now ? p->left : preempt - now;
+  now += elapsed;
+  p->left -= elapsed;
+  p->cputime += elapsed;
+  p->run_recent += elapsed;
+  interact_decay_hist(&p->sleep_recent, &p->run_recent);
+  p->time_left = p->time_left > elapsed ? p->time_left - elapsed : 0;
+  if(s->pol == MLFQ){
+    mlfq_charge_slice(&p->level, &p->slice, p->nice, elapsed);
+    p->lastoff = now;
+  }
+
+  if(p->left > 0){
+    p->state = RUNNABLE;
+    p->rstart = now;
+  } else if(p->cur + 2 < p->nburst){
+    p->state = SLEEPING;
+    p->sleep_start = now;
+    p->wake = now + p->burst[p->cur + 1];
+    p->cur += 2;
+    p->left = p->burst[p->cur];
+  } else {
+    p->state = DONE;
+    p->etime = now;
+    s->done++;
+  }
+  s->now = now;
+  admit(s);
+}
+
+// starvation_clean()
+static void
+sim_age(void *arg)
+{
+  struct sim *s = arg;
+
+  for(int i = 0; i < s->t->n; i++){
+    struct task *p = &s->t->task[i];
+    if(p->state == RUNNABLE)
+      mlfq_age(&p->level, &p->slice, p->nice, s->now - p->lastoff, MLFQ_STARVE_CUT);
+  }
+}
+
+// Next time something arrives or wakes up, or 0.
+static uint64
+next_event(struct trace *t)
+{
+  uint64 next = 0;
+  for(int i = 0; i < t->n; i++){
+    struct task *p = &t->task[i];
+    uint64 at = p->state == FUTURE ? p->arrival : p->state == SLEEPING ? p->wake : 0;
+    if(at && (next == 0 || at < next))
+      next = at;
+  }
+  return next;
+}
+
+static void
+simulate(struct trace *in, enum policy pol, struct result *r, char *log)
+{
+  static struct trace tr;
+  struct trace *t = &tr;
+  struct sim s = { t, pol, 0, 0, log, 0 };
+  struct sched_ops ops = { 0, sim_get, sim_put, sim_run, 0, sim_age, &s };
+
+  *t = *in;
+  ops.nslot = t->n;
+  if(log)
+    log[0] = 0;
+  for(int i = 0; i < t->n; i++){
+    struct task *p = &t->task[i];
+    p->state = FUTURE;
+    p->cur = 0;
+    p->left = p->burst[0];
+    p->time_left = stcf_time_left(p->hint);
+    p->level = mlfq_level(p->nice);
+    p->slice = mlfq_quantum(p->level, p->nice);
+  }
+
+  // scheduler(): one round of the policy, or idle until
+  // the next arrival or wakeup.
+  while(s.done < t->n){
+    admit(&s);
+    int found;
+    switch(pol){
+    case FIFO: found = sched_fifo(&ops); break;
+    case SJF:  found = sched_shortest(&ops, 0); break;
+    case STCF: found = sched_shortest(&ops, 1); break;
+    case MLFQ: found = sched_mlfq(&ops); break;
+    default:   found = sched_rr(&ops); break;
+    }
+    if(!found)
+      s.now = next_event(t);
+  }
+
+  double sum = 0, sumsq = 0;
+  memset(r, 0, sizeof(*r));
+  for(int i = 0; i < t->n; i++){
+    struct task *p = &t->task[i];
+    double tat = (double)(p->etime - p->arrival) / MS;
+    r->turnaround += tat;
+    r->response += (double)(p->stime - p->arrival) / MS;
+    r->waiting += (double)p->wtime / MS;
+    if(tat > r->maxturnaround)
+      r->maxturnaround = tat;
+    double slowdown = (double)(p->etime - p->arrival) / (p->cputime ? p->cputime : 1);
+    sum += slowdown;
+    sumsq += slowdown * slowdown;
+  }
+  r->turnaround /= t->n;
+  r->response /= t->n;
+  r->waiting /= t->n;
+  r->fairness = sumsq > 0 ? sum * sum / (t->n * sumsq) : 1;
+}
+
+// ---- traces ----
+
+// Add the process on one trace line to t, if the line has one.
+// Returns -1 if the line is malformed, 1 if t is full.
+static int
+addline(char *file, char *line, struct trace *t)
+{
+  char *s = line, *end;
+
+  while(*s == ' ' || *s == '\t')
+    s++;
+  if(*s == '#' || *s == '\n' || *s == 0)
+    return 0;
+  if(t->n == NTASK){
+    fprintf(stderr, "%s: more than %d processes\n", file, NTASK);
+    return 1;
+  }
+  struct task *p = &t->task[t->n];
+  int off;
+  unsigned long arrival, hint;
+  if(sscanf(s, "%15s %lu %d %lu%n", p->name, &arrival, &p->nice, &hint, &off) != 4){
+    fprintf(stderr, "%s: bad line: %s", file, line);
+    return -1;
+  }
+  p->arrival = arrival * MS;
+  p->hint = hint * MS;
+  s += off;
+  while(p->nburst < NBURST){
+    unsigned long ms = strtoul(s, &end, 10);
+    if(end == s)
+      break;
+    p->burst[p->nburst++] = ms * MS;
+    s = end;
+  }
+  if(p->nburst % 2 == 0){
+    fprintf(stderr, "%s: %s must end with a cpu burst\n", file, p->name);
+    return -1;
+  }
+  p->pid = ++t->n;
+  return 0;
+}
+
+static int
+readtrace(char *file, struct trace *t)
+{
+  FILE *f = fopen(file, "r");
+  char line[512];
+
+  if(f == 0){
+    perror(file);
+    return -1;
+  }
+  memset(t, 0, sizeof(*t));
+  while(fgets(line, sizeof(line), f)){
+    int r = addline(file, line, t);
+    if(r < 0){
+      fclose(f);
+      return -1;
+    }
+    if(r > 0)
+      break;
+  }
+  fclose(f);
+  return 0;
+}
+
+// A random mix of short and long, CPU- and I/O-bound processes,
+// with accurate hints.
+static void
+randtrace(struct trace *t)
+{
+  memset(t, 0, sizeof(*t));
+  t->n = 4 + rand() % 12;
+  for(int i = 0; i < t->n; i++){
+    struct task *p = &t->task[i];
+    snprintf(p->name, sizeof(p->name), "p%d", i + 1);
+    p->pid = i + 1;
+    p->arrival = (rand() % 2000) * MS;
+    p->nburst = 1 + 2 * (rand() % 4);
+    uint64 total = 0;
+    for(int b = 0; b < p->nburst; b++){
+      if(b % 2 == 0){
+        // CPU bursts: mostly short, sometimes long
+        p->burst[b] = (rand() % 4 == 0 ? 200 + rand() % 800 : 5 + rand() % 50) * MS;
+        total += p->burst[b];
+      } else {
+        p->burst[b] = (10 + rand() % 100) * MS;
+      }
+    }
+    p->hint = total;
+  }
+}
+
+static void
+report(char *name, enum policy pol, struct result *r)
+{
+  printf("%-16s %-5s turnaround %9.1f ms (max %9.1f)  response %8.1f ms  waiting %9.1f ms  fairness %.3f\n",
+         name, policies[pol], r->turnaround, r->maxturnaround, r->response, r->waiting, r->fairness);
+}
+
+// ---- self-test ----
+
+// Small traces and the order in which the kernel dispatches their
+// processes (pids, one per dispatch), worked out by hand from
+// scheduler() with TICK = 100 ms.
+static struct {
+  char *name;
+  enum policy pol;
+  char *lines[4];
+  char *want;
+} tests[] = {
+  // b (nice 5) is passed over every other pass, and a pass in
+  // which it is the only one and is passed over runs nothing.
+  { "rr-passover", RR, { "a 0 0 0 250", "b 0 5 0 250" }, "1 2 1 1 2 2" },
+  // no hints: SJF runs round robin passes.
+  { "sjf-nohint", SJF, { "a 0 0 0 150", "b 0 0 0 150" }, "1 2 1 2" },
+  { "sjf-hint", SJF, { "a 0 0 150 150", "b 0 0 50 50" }, "2 1 1" },
+  { "fifo", FIFO, { "a 10 0 0 50", "b 0 0 0 150" }, "2 2 1" },
+  // b's 51 units left beat a's 201 once a has run a tick.
+  { "stcf", STCF, { "a 0 0 300 300", "b 50 0 50 50" }, "1 2 1 1 1" },
+  // a uses up its level 0 quantum in its first tick, so b,
+  // still at level 0, goes before it.
+  { "mlfq-demote", MLFQ, { "a 0 0 0 150", "b 50 0 0 10" }, "1 2 1" },
+};
+
+static int
+selftest(void)
+{
+  static struct trace t;
+  static char log[LOGSZ];
+  struct result r;
+  int fail = 0;
+
+  for(int i = 0; i < sizeof(tests) / sizeof(tests[0]); i++){
+    memset(&t, 0, sizeof(t));
+    for(int l = 0; l < 4 && tests[i].lines[l]; l++)
+      if(addline(tests[i].name, tests[i].lines[l], &t) != 0)
+        return 1;
+    simulate(&t, tests[i].pol, &r, log);
+    if(strcmp(log, tests[i].want) != 0){
+      printf("%s: FAIL: dispatched %s, want %s\n", tests[i].name, log, tests[i].want);
+      fail = 1;
+    } else {
+      printf("%s: OK\n", tests[i].name);
+    }
+  }
+  return fail;
+}
+
+static void
+usage(void)
+{
+  fprintf(stderr, "usage: schedsim [-p policy] trace...\n"
+                  "       schedsim [-p policy] -r ntraces [-s seed]\n"
+                  "       schedsim -t\n");
+  exit(1);
+}
+
+int
+main(int argc, char *argv[])
+{
+  static struct trace t;
+  struct result r;
+  int only = -1, ntraces = 0, i;
+  unsigned seed = 1;
+
+  for(i = 1; i < argc && argv[i][0] == '-'; i++){
+    if(strcmp(argv[i], "-p") == 0 && i + 1 < argc){
+      for(only = 0; only < NPOLICY; only++)
+        if(strcmp(argv[i+1], policies[only]) == 0)
+          break;
+      if(only == NPOLICY)
+        usage();
+      i++;
+    } else if(strcmp(argv[i], "-r") == 0 && i + 1 < argc){
+      ntraces = atoi(argv[++i]);
+    } else if(strcmp(argv[i], "-s") == 0 && i + 1 < argc){
+      seed = atoi(argv[++i]);
+    } else if(strcmp(argv[i], "-t") == 0){
+      return selftest();
+    } else {
+      usage();
+    }
+  }
+  if(ntraces == 0 && i == argc)
+    usage();
+
+  for(int pol = 0; pol < NPOLICY; pol++){
+    if(only >= 0 && pol != only)
+      continue;
+    if(ntraces > 0){
+      struct result avg;
+      memset(&avg, 0, sizeof(avg));
+      srand(seed);
+      for(int n = 0; n < ntraces; n++){
+        randtrace(&t);
+        simulate(&t, pol, &r, 0);
+        avg.turnaround += r.turnaround / ntraces;
+        avg.response += r.response / ntraces;
+        avg.waiting += r.waiting / ntraces;
+        avg.fairness += r.fairness / ntraces;
+        if(r.maxturnaround > avg.maxturnaround)
+          avg.maxturnaround = r.maxturnaround;
+      }
+      report("random", pol, &avg);
+    } else {
+      for(int a = i; a < argc; a++){
+        if(readtrace(argv[a], &t) < 0)
+          exit(1);
+        if(t.n == 0)
+          continue;
+        simulate(&t, pol, &r, 0);
+        report(argv[a], pol, &r);
+      }
+    }
+  }
+  return 0;
+}
@@ -7,22 +7,30 @@
 # ./test-xv6.py -q usertests (runs the quick tests of usertests)
 # ./test-xv6.py crash  (runs the crash tests)
 # ./test-xv6.py log (runs the log crash test)
+# ./test-xv6.py bench -n 5 --cpus 1,2,4 (scheduler benchmark matrix)
 
-import argparse, os, inspect, re, signal, subprocess, sys, time
+import argparse, json, os, inspect, re, select, signal, subprocess, sys, time
 from subprocess import run
 
 parser = argparse.ArgumentParser()
 parser.add_argument('testrex', help="test name or regular expression")
 parser.add_argument("-q", action='store_true', help="usertests quick")
+parser.add_argument("-n", type=int, default=3, help="bench: repetitions per configuration")
+parser.add_argument("--policies", default="RR,FIFO,SJF,STCF,MLFQ", help="bench: SCHEDPOLICY values")
+parser.add_argument("--cpus", default="1,2,4", help="bench: CPUS values")
+parser.add_argument("--scenarios", default="short convoy interactive iomix poisson bursty",
+                    help="bench: schedeval scenarios")
+parser.add_argument("--results", default="bench-results.json", help="bench: JSON results file")
 args = parser.parse_args()
 
 class QEMU(object):
 
-    def __init__(self, reset=False):
+    def __init__(self, reset=False, make_args=[]):
+        self.make_args = make_args
         if reset:
             self.build_xv6()
             self.reset_fs()
-        q = ["make", "qemu"]
+        q = ["make", "qemu"] + make_args
         self.proc = subprocess.Popen(q, stdin=subprocess.PIPE,
                                       stdout=subprocess.PIPE,
                                       stderr=subprocess.STDOUT)
@@ -33,20 +41,20 @@ class QEMU(object):
     def reset_fs(self):
         try:
             run(["rm", "fs.img"], check=True)
-            run(["make", "fs.img"], check=True)
+            run(["make", "fs.img"] + self.make_args, check=True)
         except subprocess.CalledProcessError as e:
             print(f"Command failed with exit code {e.returncode}")
 
     def build_xv6(self):
         try:
-            run(["make", "kernel/kernel"], check=True)
+            run(["make", "kernel/kernel"] + self.make_args, check=True)
         except subprocess.CalledProcessError as e:
             print(f"Command failed with exit code {e.returncode}")
 
     def save_output(self):
       try:
         with open("test-xv6.out", "w") as f:
-            f.write(self.out)
+            f.write(self.output)
             f.close()
       except OSError as e:
         print("Provided a bad results path. Error:", e)     
@@ -69,8 +77,13 @@ class QEMU(object):
     def stop(self):
         self.proc.terminate()
 
-    def read(self):
-        buf = os.read(self.proc.stdout.fileno(), 4096)
+    # Read what QEMU has printed. With a timeout, give up after
+    # that many seconds if it has printed nothing.
+    def read(self, timeout=None):
+        fd = self.proc.stdout.fileno()
+        if timeout is not None and not select.select([fd], [], [], timeout)[0]:
+            return
+        buf = os.read(fd, 4096)
         self.outbytes.extend(buf)
         self.output = self.outbytes.decode("utf-8", "replace")
 
@@ -213,4 +226,138 @@ def main():
     if none:
         test_usertests(test=args.testrex)
 
+#
+# bench: build and boot every SCHEDPOLICY x CPUS configuration,
+# run schedeval, schedbench and lockbench args.n times in each, and write the
+# parsed results to args.results with percentile tables.
+#
+
+def percentile(xs, p):
+    if not xs:
+        return 0
+    xs = sorted(xs)
+    return xs[min(len(xs) - 1, max(0, (len(xs) * p + 99) // 100 - 1))]
+
+bench_seq = 0
+
+# Run shell command c and return the lines it printed.
+def bench_cmd(q, c, timeout=900):
+    global bench_seq
+    bench_seq += 1
+    done = "BENCH-DONE-%d" % bench_seq
+    # the previous command's output, up to its prompt, has been read.
+    start = len(q.output)
+    q.cmd(c + "; echo " + done + "\n")
+    deadline = time.time() + timeout
+    while done not in q.output[start:].splitlines():
+        if time.time() > deadline:
+            print("FAIL: timeout running", c)
+            q.save_output()
+            q.stop()
+            sys.exit(1)
+        q.read(timeout=1)
+    return q.output[start:].splitlines()
+
+# schedeval: per-job times (us) and per-scenario throughput (jobs/s).
+def parse_schedeval(lines):
+    jobs, scen = [], []
+    first, last, n = None, None, 0
+    def flush():
+        if n > 0 and last > first:
+            scen.append(n * 1000000.0 / (last - first))
+    for line in lines:
+        if re.match(r'^=== (?!COMPLETION)', line):
+            flush()
+            first, last, n = None, None, 0
+        m = re.match(r'^pid: \d+, ctime \(creation time\): (\d+), .* etime \(exit time\): (\d+)', line)
+        if m:
+            c, e = int(m.group(1)), int(m.group(2))
+            first = c if first is None else min(first, c)
+            last = e if last is None else max(last, e)
+            n += 1
+        m = re.match(r'^turnaround time (\d+) \S+, waiting time (\d+) \S+, response time (\d+)', line)
+        if m:
+            jobs.append({"turnaround": int(m.group(1)), "waiting": int(m.group(2)),
+                         "response": int(m.group(3))})
+    flush()
+    return jobs, scen
+
+# schedbench: test iters mean_ns p50_ns p99_ns min_ns max_ns
+def parse_schedbench(lines):
+    res = {}
+    for line in lines:
+        f = line.split()
+        if len(f) == 7 and f[0] in ("gettime", "sys_gettime", "yield", "pipe", "wakeup", "fork", "exec"):
+            res[f[0]] = {"iters": int(f[1]), "mean_ns": int(f[2]), "p50_ns": int(f[3]),
+                         "p99_ns": int(f[4]), "min_ns": int(f[5]), "max_ns": int(f[6])}
+    return res
+
+# lockbench: kind procs iters total_us ops_per_ms first_us contended mean_spin
+# (for fsread, the last two are inode sleeplock sleeps and mean wait in us)
+def parse_lockbench(lines):
+    res = {}
+    for line in lines:
+        f = line.split()
+        if len(f) == 8 and f[0] in ("tas", "ticket", "mcs", "fsread"):
+            res[f[0]] = {"ops_per_ms": int(f[4]), "total_us": int(f[3]), "first_us": int(f[5]),
+                         "contended": int(f[6]), "mean_spin": int(f[7])}
+    return res
+
+def bench_config(policy, cpus):
+    make_args = ["SCHEDPOLICY=" + policy, "CPUS=" + str(cpus)]
+    q = QEMU(True, make_args)
+    time.sleep(2)
+    result = {"policy": policy, "cpus": cpus, "jobs": [], "throughput": [], "schedbench": [],
+              "lockbench": []}
+    for rep in range(args.n):
+        print("%s cpus=%d run %d/%d" % (policy, cpus, rep + 1, args.n))
+        lines = bench_cmd(q, "schedeval -s %d %s" % (rep + 1, args.scenarios))
+        jobs, scen = parse_schedeval(lines)
+        result["jobs"] += jobs
+        result["throughput"] += scen
+        result["schedbench"].append(parse_schedbench(bench_cmd(q, "schedbench")))
+        result["lockbench"].append(parse_lockbench(bench_cmd(q, "lockbench -p %d" % max(2, cpus))))
+    q.crash()
+    q.stop()
+    return result
+
+def bench_table(results):
+    print("\n%-6s %4s %26s %26s %12s" % ("", "", "turnaround us", "response us", "jobs/s"))
+    print("%-6s %4s %8s %8s %8s %8s %8s %8s %12s" %
+          ("policy", "cpus", "p50", "p95", "p99", "p50", "p95", "p99", "p50"))
+    for r in results:
+        tat = [j["turnaround"] for j in r["jobs"]]
+        rt = [j["response"] for j in r["jobs"]]
+        print("%-6s %4d %8d %8d %8d %8d %8d %8d %12.1f" %
+              (r["policy"], r["cpus"], percentile(tat, 50), percentile(tat, 95), percentile(tat, 99),
+               percentile(rt, 50), percentile(rt, 95), percentile(rt, 99),
+               percentile(r["throughput"], 50)))
+    tests = ["sys_gettime", "yield", "pipe", "wakeup", "fork", "exec"]
+    print("\n%-6s %4s " % ("policy", "cpus") + " ".join("%10s" % t for t in tests) + "   (p50 of mean ns)")
+    for r in results:
+        cols = [percentile([b[t]["mean_ns"] for b in r["schedbench"] if t in b], 50) for t in tests]
+        print("%-6s %4d " % (r["policy"], r["cpus"]) + " ".join("%10d" % c for c in cols))
+    kinds = ["tas", "ticket", "mcs", "fsread"]
+    print("\n%-6s %4s " % ("policy", "cpus") + " ".join("%10s %7s" % (k, "fair") for k in kinds) +
+          "   (p50 ops/ms, first/last finish)")
+    for r in results:
+        cols = []
+        for k in kinds:
+            runs = [b[k] for b in r["lockbench"] if k in b]
+            cols.append("%10d %7.2f" % (percentile([b["ops_per_ms"] for b in runs], 50),
+                        percentile([b["first_us"] / max(1, b["total_us"]) for b in runs], 50)))
+        print("%-6s %4d " % (r["policy"], r["cpus"]) + " ".join(cols))
+
+def test_bench():
+    results = []
+    for policy in args.policies.split(","):
+        # the policy is compiled in, so rebuild everything
+        run(["make", "clean"], check=True)
+        for cpus in [int(c) for c in args.cpus.split(",")]:
+            results.append(bench_config(policy, cpus))
+            with open(args.results, "w") as f:
+                json.dump(results, f, indent=1)
+    bench_table(results)
+    print("results in", args.results)
+
 main()
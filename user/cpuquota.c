@@ -0,0 +1,45 @@
+#include "kernel/types.h"
+#include "kernel/stat.h"
+#include "user/user.h"
+
+// cpuquota quota_ms period_ms command [args...]
+// run command in a new process group limited to quota_ms of
+// CPU time every period_ms, then report how often it was throttled.
+int
+main(int argc, char *argv[])
+{
+  struct pgroupinfo info;
+  int quota, period, pid;
+
+  if(argc < 4){
+    fprintf(2, "usage: cpuquota quota_ms period_ms command [args...]\n");
+    exit(1);
+  }
+  quota = atoi(argv[1]) * 10000;
+  period = atoi(argv[2]) * 10000;
+
+  pid = fork();
+  if(pid < 0){
+    fprintf(2, "cpuquota: fork failed\n");
+    exit(1);
+  }
+  if(pid == 0){
+    if(setpgid(0, 0) < 0 || setquota(getpid(), quota, period) < 0){
+      fprintf(2, "cpuquota: cannot set quota\n");
+      exit(1);
+    }
+    exec(argv[3], argv + 3);
+    fprintf(2, "cpuquota: exec %s failed\n", argv[3]);
+    exit(1);
+  }
+
+  // stay in the group, so that its statistics outlive the child.
+  setpgid(0, pid);
+  wait(0);
+  if(getpgroupinfo(pid, &info) == 0){
+    printf("pgid %d: throttled %lu times, %lu ms in total\n",
+           info.pgid, info.nthrottled, info.throttled_time / 10000);
+  }
+  setquota(pid, 0, 0);
+  exit(0);
+}
@@ -0,0 +1,75 @@
+#include "kernel/types.h"
+#include "kernel/stat.h"
+#include "kernel/param.h"
+#include "user/user.h"
+
+// cpustat [command [args...]]
+// print each CPU's scheduler statistics: how its time split
+// between idle, running processes and scheduling, and what the
+// scheduling decisions cost. With a command, only count what
+// happened while it ran.
+
+struct cpustats before[NCPU], after[NCPU];
+
+// a -= b. The maximums can't be taken apart, so they
+// stay the maximums since boot.
+void
+diff(struct cpustats *a, struct cpustats *b)
+{
+  a->idle -= b->idle;
+  a->busy -= b->busy;
+  a->sched -= b->sched;
+  a->decide.count -= b->decide.count;
+  a->decide.sum -= b->decide.sum;
+  for(int i = 0; i < NHIST; i++)
+    a->decide.bucket[i] -= b->decide.bucket[i];
+  a->nswitch -= b->nswitch;
+  a->ntimer -= b->ntimer;
+  a->nrqsample -= b->nrqsample;
+  a->rqsum -= b->rqsum;
+}
+
+int
+main(int argc, char *argv[])
+{
+  int n;
+
+  if(argc > 1){
+    getcpustats(before, NCPU);
+    int pid = fork();
+    if(pid < 0){
+      fprintf(2, "cpustat: fork failed\n");
+      exit(1);
+    }
+    if(pid == 0){
+      exec(argv[1], argv + 1);
+      fprintf(2, "cpustat: exec %s failed\n", argv[1]);
+      exit(1);
+    }
+    wait(0);
+  }
+
+  if((n = getcpustats(after, NCPU)) < 0){
+    fprintf(2, "cpustat: getcpustats failed\n");
+    exit(1);
+  }
+  for(int i = 0; i < n; i++){
+    struct cpustats *st = &after[i];
+    if(st->ntimer == 0)
+      continue;   // CPU not present
+    if(argc > 1)
+      diff(st, &before[i]);
+    uint64 total = st->idle + st->busy + st->sched;
+    if(total == 0)
+      total = 1;
+    printf("cpu %d: idle %lu%% busy %lu%% sched %lu%%, %lu switches, %lu timer ints\n",
+           i, st->idle * 100 / total, st->busy * 100 / total, st->sched * 100 / total,
+           st->nswitch, st->ntimer);
+    printf("  decisions %lu, mean %lu cycles, max %lu cycles; run queue mean %lu max %lu\n",
+           st->decide.count,
+           st->decide.count ? st->decide.sum / st->decide.count : 0,
+           st->decide.max,
+           st->nrqsample ? st->rqsum / st->nrqsample : 0, st->rqmax);
+  }
+  exit(0);
+}
@@ -0,0 +1,113 @@
+#include "kernel/types.h"
+#include "kernel/stat.h"
+#include "kernel/param.h"
+#include "user/user.h"
+
+// cyclictest [-l loops] [-t threads] [-b hogs] [-i interval_us]
+// measure how late sleeping processes get back to user space
+// after their wakeup. Each of threads processes, at nice values
+// spread from -10 to 10, nanosleep()s for interval (default 10 ms)
+// loops times while hogs CPU-bound processes run. The kernel
+// timestamps each wakeup and the process's next return to user
+// space (getwaithist() WAKEHIST_PROC); the differences are
+// reported per process.
+
+int loops = 50, nthreads = 3, nhogs = 2, interval = 10000;
+
+// 10MHz clock: 100 ns per unit.
+void
+print(int id, int nice, struct hist *h)
+{
+  printf("T%d nice %d: %lu wakeups, min %lu us, avg %lu us, max %lu us\n",
+         id, nice, h->count, h->count ? h->min / 10 : 0,
+         h->count ? h->sum / h->count / 10 : 0, h->max / 10);
+  for(int i = 0; i < NHIST; i++){
+    if(h->bucket[i] == 0)
+      continue;
+    // bucket i holds latencies below 2^i clock units
+    printf("  < %lu us: %lu\n", ((1UL << i) + 9) / 10, h->bucket[i]);
+  }
+}
+
+// Sleep for interval loops times, then send our wakeup latency
+// histogram to the parent.
+void
+measure(int nice, int fd)
+{
+  struct hist h;
+
+  setpriority(getpid(), nice);
+  for(int i = 0; i < loops; i++)
+    nanosleep(interval * 10);
+  if(getwaithist(WAKEHIST_PROC, getpid(), &h) < 0){
+    fprintf(2, "cyclictest: getwaithist failed\n");
+    exit(1);
+  }
+  write(fd, &h, sizeof(h));
+  exit(0);
+}
+
+int
+main(int argc, char *argv[])
+{
+  int hogs[NPROC], fds[NPROC][2];
+  struct hist h;
+
+  for(int i = 1; i + 1 < argc; i += 2){
+    if(strcmp(argv[i], "-l") == 0)
+      loops = atoi(argv[i+1]);
+    else if(strcmp(argv[i], "-t") == 0)
+      nthreads = atoi(argv[i+1]);
+    else if(strcmp(argv[i], "-b") == 0)
+      nhogs = atoi(argv[i+1]);
+    else if(strcmp(argv[i], "-i") == 0)
+      interval = atoi(argv[i+1]);
+    else
+      break;
+  }
+  if(loops <= 0 || nthreads <= 0 || nthreads > 16 || nhogs < 0 || nhogs > 16 || interval <= 0){
+    fprintf(2, "usage: cyclictest [-l loops] [-t threads(1-16)] [-b hogs(0-16)] [-i interval_us]\n");
+    exit(1);
+  }
+
+  for(int i = 0; i < nhogs; i++){
+    if((hogs[i] = fork()) == 0)
+      for(;;)
+        ;
+  }
+
+  for(int i = 0; i < nthreads; i++){
+    int nice = nthreads == 1 ? 0 : -10 + 20 * i / (nthreads - 1);
+    if(pipe(fds[i]) < 0){
+      fprintf(2, "cyclictest: pipe failed\n");
+      exit(1);
+    }
+    int pid = fork();
+    if(pid < 0){
+      fprintf(2, "cyclictest: fork failed\n");
+      exit(1);
+    }
+    if(pid == 0){
+      close(fds[i][0]);
+      measure(nice, fds[i][1]);
+    }
+    close(fds[i][1]);
+  }
+
+  printf("%d threads x %d loops of %d us, %d hogs\n", nthreads, loops, interval, nhogs);
+  for(int i = 0; i < nthreads; i++){
+    int nice = nthreads == 1 ? 0 : -10 + 20 * i / (nthreads - 1);
+    if(read(fds[i][0], &h, sizeof(h)) != sizeof(h)){
+      fprintf(2, "cyclictest: T%d failed\n", i);
+      continue;
+    }
+    close(fds[i][0]);
+    print(i, nice, &h);
+  }
+
+  for(int i = 0; i < nhogs; i++)
+    kill(hogs[i]);
+  while(wait(0) > 0)
+    ;
+  exit(0);
+}
@@ -0,0 +1,74 @@
+#include "kernel/types.h"
+#include "kernel/stat.h"
+#include "user/user.h"
+
+// exitstat [-r] [command [args...]]
+// print the kernel's statistics for processes that have exited.
+// -r clears them afterwards. With a command, clear them, run the
+// command, and print the statistics of everything it ran.
+
+// Estimate the p-th percentile of h: the upper bound of the
+// bucket holding it, capped at the largest value seen.
+uint64
+percentile(struct hist *h, int p)
+{
+  uint64 want = (h->count * p + 99) / 100;
+  uint64 seen = 0;
+
+  for(int i = 0; i < NHIST; i++){
+    seen += h->bucket[i];
+    if(seen >= want && seen > 0){
+      uint64 top = i == 0 ? 0 : (1UL << i) - 1;
+      return top < h->max ? top : h->max;
+    }
+  }
+  return h->max;
+}
+
+// times are in 10MHz clock units; print them in microseconds.
+void
+print(char *name, struct hist *h)
+{
+  printf("%s: mean %lu us, p50 %lu us, p90 %lu us, p99 %lu us, max %lu us\n",
+         name, h->count ? h->sum / h->count / 10 : 0,
+         percentile(h, 50) / 10, percentile(h, 90) / 10,
+         percentile(h, 99) / 10, h->max / 10);
+}
+
+int
+main(int argc, char *argv[])
+{
+  struct exitstats st;
+  int reset = 0;
+
+  if(argc > 1 && strcmp(argv[1], "-r") == 0){
+    reset = 1;
+    argc--;
+    argv++;
+  }
+
+  if(argc > 1){
+    exitstats(0, 1);
+    int pid = fork();
+    if(pid < 0){
+      fprintf(2, "exitstat: fork failed\n");
+      exit(1);
+    }
+    if(pid == 0){
+      exec(argv[1], argv + 1);
+      fprintf(2, "exitstat: exec %s failed\n", argv[1]);
+      exit(1);
+    }
+    wait(0);
+  }
+
+  if(exitstats(&st, reset) < 0){
+    fprintf(2, "exitstat: exitstats failed\n");
+    exit(1);
+  }
+  printf("%lu processes exited\n", st.turnaround.count);
+  print("turnaround", &st.turnaround);
+  print("response", &st.response);
+  print("waiting", &st.waiting);
+  exit(0);
+}
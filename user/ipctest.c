@@ -0,0 +1,266 @@
+#include "kernel/types.h"
+#include "kernel/stat.h"
+#include "user/user.h"
+
+#define ROUNDS 2000
+#define NHOG 4
+#define HANDOFFS 10
+
+// ------------------------------------------------------------
+// TEST 1: YIELD_TO
+// yield_to() a live child succeeds, a bogus pid fails
+// ------------------------------------------------------------
+int test_yield_to()
+{
+    printf("\n=== TEST 1: YIELD_TO ===\n");
+
+    int child = fork();
+    if (child == 0)
+    {
+        for (int i = 0; i < 20; i++)
+            yield();
+        exit(0);
+    }
+
+    int ok = 1;
+    for (int i = 0; i < 20; i++)
+    {
+        if (yield_to(child) != 0)
+        {
+            ok = 0;
+            break;
+        }
+    }
+    wait(0);
+
+    if (yield_to(child) != -1 || yield_to(getpid()) != -1 || yield_to(0) != -1)
+        ok = 0;
+
+    return ok;
+}
+
+// ------------------------------------------------------------
+// TEST 2: SEND/RECV PING-PONG
+// client sends i, server replies i+1; checks payload and sender pid
+// ------------------------------------------------------------
+int test_pingpong()
+{
+    printf("\n=== TEST 2: SEND/RECV PING-PONG ===\n");
+
+    int server = fork();
+    if (server == 0)
+    {
+        for (int i = 0; i < ROUNDS; i++)
+        {
+            int from = 0, v;
+            if (recv(&from, &v, sizeof(v)) != sizeof(v))
+                exit(1);
+            v++;
+            if (send(from, &v, sizeof(v)) != sizeof(v))
+                exit(1);
+        }
+        exit(0);
+    }
+
+    int ok = 1;
+    int t0 = uptime();
+    for (int i = 0; i < ROUNDS; i++)
+    {
+        int from = server, v = i;
+        if (send(server, &v, sizeof(v)) != sizeof(v) ||
+            recv(&from, &v, sizeof(v)) != sizeof(v) ||
+            from != server || v != i + 1)
+        {
+            printf("round %d failed\n", i);
+            ok = 0;
+            kill(server);
+            break;
+        }
+    }
+    int t1 = uptime();
+
+    int status;
+    wait(&status);
+    if (status != 0)
+        ok = 0;
+
+    printf("%d send/recv round trips in %d ticks\n", ROUNDS, t1 - t0);
+    return ok;
+}
+
+// ------------------------------------------------------------
+// TEST 3: PIPE PING-PONG (baseline for TEST 2)
+// ------------------------------------------------------------
+int test_pipe_baseline()
+{
+    printf("\n=== TEST 3: PIPE PING-PONG ===\n");
+
+    int req[2], rep[2];
+    if (pipe(req) < 0 || pipe(rep) < 0)
+        return 0;
+
+    int server = fork();
+    if (server == 0)
+    {
+        close(req[1]);
+        close(rep[0]);
+        int v;
+        while (read(req[0], &v, sizeof(v)) == sizeof(v))
+        {
+            v++;
+            write(rep[1], &v, sizeof(v));
+        }
+        exit(0);
+    }
+    close(req[0]);
+    close(rep[1]);
+
+    int ok = 1;
+    int t0 = uptime();
+    for (int i = 0; i < ROUNDS; i++)
+    {
+        int v = i;
+        if (write(req[1], &v, sizeof(v)) != sizeof(v) ||
+            read(rep[0], &v, sizeof(v)) != sizeof(v) || v != i + 1)
+        {
+            ok = 0;
+            break;
+        }
+    }
+    int t1 = uptime();
+    close(req[1]);
+    close(rep[0]);
+    wait(0);
+
+    printf("%d pipe round trips in %d ticks\n", ROUNDS, t1 - t0);
+    return ok;
+}
+
+// ------------------------------------------------------------
+// TEST 4: SEND TO A DEAD PROCESS
+// ------------------------------------------------------------
+int test_dead_peer()
+{
+    printf("\n=== TEST 4: DEAD PEER ===\n");
+
+    int child = fork();
+    if (child == 0)
+        exit(0);
+    wait(0);
+
+    int v = 0;
+    int from = child;
+    return send(child, &v, sizeof(v)) == -1 && recv(&from, &v, sizeof(v)) == -1;
+}
+
+// ------------------------------------------------------------
+// TEST 5: PEER EXITS WHILE WE ARE BLOCKED
+// send() and recv() blocked on a child must fail when it exits
+// ------------------------------------------------------------
+int test_peer_exits()
+{
+    printf("\n=== TEST 5: PEER EXITS ===\n");
+
+    int v = 0;
+    int child = fork();
+    if (child == 0) {
+        pause(5);
+        exit(0);
+    }
+    int sent = send(child, &v, sizeof(v));
+    wait(0);
+
+    child = fork();
+    if (child == 0) {
+        pause(5);
+        exit(0);
+    }
+    int from = child;
+    int got = recv(&from, &v, sizeof(v));
+    wait(0);
+
+    return sent == -1 && got == -1;
+}
+
+// ------------------------------------------------------------
+// TEST 6: HANDOFF RUNS THE RECEIVER NEXT
+// with CPU hogs runnable, a receiver woken by send() must run
+// well within one of their 100ms ticks
+// ------------------------------------------------------------
+int test_handoff_next()
+{
+    printf("\n=== TEST 6: HANDOFF RUNS NEXT ===\n");
+
+    int hogs[NHOG];
+    for (int i = 0; i < NHOG; i++)
+    {
+        hogs[i] = fork();
+        if (hogs[i] == 0)
+            for (;;)
+                ;
+    }
+
+    int server = fork();
+    if (server == 0)
+    {
+        uint64 worst = 0;
+        for (int i = 0; i < HANDOFFS; i++)
+        {
+            int from = 0;
+            uint64 t0;
+            if (recv(&from, &t0, sizeof(t0)) != sizeof(t0))
+                exit(1);
+            uint64 d = gettime() - t0;
+            if (d > worst)
+                worst = d;
+        }
+        printf("worst send-to-recv latency %lu us\n", worst / 10);
+        exit(worst < 500000 ? 0 : 1);   // 50 ms
+    }
+
+    int ok = 1;
+    struct procinfo info;
+    for (int i = 0; i < HANDOFFS && ok; i++)
+    {
+        // send only once the server is blocked in recv().
+        while (getprocinfo(server, &info) == 0 && info.state != SLEEPING)
+            yield();
+        uint64 t0 = gettime();
+        if (send(server, &t0, sizeof(t0)) != sizeof(t0))
+            ok = 0;
+    }
+
+    int status;
+    for (int i = 0; i < NHOG; i++)
+        kill(hogs[i]);
+    for (int i = 0; i < NHOG + 1; i++)
+        if (wait(&status) == server && status != 0)
+            ok = 0;
+    return ok;
+}
+
+int main()
+{
+    printf("===== IPC TEST SUITE =====\n");
+
+    int pass_yt = test_yield_to();
+    int pass_pp = test_pingpong();
+    int pass_pipe = test_pipe_baseline();
+    int pass_dead = test_dead_peer();
+    int pass_exit = test_peer_exits();
+    int pass_next = test_handoff_next();
+
+    printf("\n===== RESULTS =====\n");
+    printf("Test 1 (yield_to):        %s\n", pass_yt ? "PASS" : "FAIL");
+    printf("Test 2 (send/recv):       %s\n", pass_pp ? "PASS" : "FAIL");
+    printf("Test 3 (pipe baseline):   %s\n", pass_pipe ? "PASS" : "FAIL");
+    printf("Test 4 (dead peer):       %s\n", pass_dead ? "PASS" : "FAIL");
+    printf("Test 5 (peer exits):      %s\n", pass_exit ? "PASS" : "FAIL");
+    printf("Test 6 (handoff next):    %s\n", pass_next ? "PASS" : "FAIL");
+
+    int total = pass_yt + pass_pp + pass_pipe + pass_dead + pass_exit + pass_next;
+
+    printf("Passed %d / 6 tests.\n", total);
+
+    exit(0);
+}
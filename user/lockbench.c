@@ -0,0 +1,162 @@
+#include "kernel/types.h"
+#include "kernel/stat.h"
+#include "kernel/param.h"
+#include "kernel/spinlock.h"
+#include "kernel/fcntl.h"
+#include "user/user.h"
+
+// lockbench [-p procs] [-n iters] [-w work]
+// compare the kernel's spinlock kinds. For each of tas, ticket
+// and mcs, procs processes (default 4; boot with CPUS=4 or more)
+// start together and each take a kernel lock of that kind iters
+// times, doing work updates of shared data while holding it.
+// Prints one line per kind,
+//   kind procs iters total_us ops_per_ms first_us contended mean_spin
+// where first_us is when the first process finished: a fair lock
+// finishes them all close to total_us. contended and mean_spin
+// (cycles per contended acquisition) come from getlockstat().
+// A last fsread line has the processes open, read and close one
+// file iters/20 times each, contending for its inode and buffer
+// sleeplocks; its last two columns are the inode acquisitions
+// that slept and the mean us spent in acquiresleep().
+
+int nprocs = 4, iters = 20000, work = 20;
+
+char *kinds[] = { [LOCK_TAS] "tas", [LOCK_TICKET] "ticket", [LOCK_MCS] "mcs" };
+
+// The statistics of lock class name, or zeros.
+struct lockstat
+classstat(char *name)
+{
+  static struct lockstat st[NLOCKCLASS];
+  struct lockstat zero;
+  int n = getlockstat(st, NLOCKCLASS);
+
+  for(int i = 0; i < n; i++)
+    if(strcmp(st[i].name, name) == 0)
+      return st[i];
+  memset(&zero, 0, sizeof(zero));
+  return zero;
+}
+
+// Open, read and close the fsread file n times.
+int
+fsread(int n)
+{
+  char buf[512];
+
+  for(int i = 0; i < n; i++){
+    int fd = open("lockbench.tmp", O_RDONLY);
+    if(fd < 0 || read(fd, buf, sizeof(buf)) != sizeof(buf))
+      return -1;
+    close(fd);
+  }
+  return 0;
+}
+
+// Run kind's benchmark, or with kind -1 fsread's.
+void
+bench(int kind)
+{
+  char name[16] = "bench-", c = 0;
+  int go[2], done[2], n = kind < 0 ? iters / 20 : iters;
+  uint64 t0, t, first = 0, last = 0;
+
+  if(kind < 0)
+    strcpy(name, "inode");
+  else
+    strcpy(name + 6, kinds[kind]);
+  if(pipe(go) < 0 || pipe(done) < 0){
+    fprintf(2, "lockbench: pipe failed\n");
+    exit(1);
+  }
+  for(int i = 0; i < nprocs; i++){
+    int pid = fork();
+    if(pid < 0){
+      fprintf(2, "lockbench: fork failed\n");
+      exit(1);
+    }
+    if(pid == 0){
+      close(go[1]);
+      close(done[0]);
+      read(go[0], &c, 1);
+      if((kind < 0 ? fsread(n) : lockbench(kind, iters, work)) < 0)
+        exit(1);
+      t = gettime();
+      write(done[1], &t, sizeof(t));
+      exit(0);
+    }
+  }
+  close(go[0]);
+  close(done[1]);
+
+  struct lockstat before = classstat(name);
+  t0 = gettime();
+  for(int i = 0; i < nprocs; i++)
+    write(go[1], &c, 1);
+  for(int i = 0; i < nprocs; i++){
+    if(read(done[0], &t, sizeof(t)) != sizeof(t))
+      break;
+    if(first == 0 || t < first)
+      first = t;
+    if(t > last)
+      last = t;
+  }
+  close(go[1]);
+  close(done[0]);
+  while(wait(0) > 0)
+    ;
+  struct lockstat after = classstat(name);
+
+  uint64 total = last > t0 ? last - t0 : 1;   // 10MHz clock units
+  uint64 ncont, mean;
+  if(kind < 0){
+    uint64 nacq = after.nsleepacq - before.nsleepacq;
+    ncont = after.nslept - before.nslept;
+    mean = nacq ? (after.wait - before.wait) / nacq / 10 : 0;
+  } else {
+    ncont = after.ncontended - before.ncontended;
+    mean = ncont ? (after.spin - before.spin) / ncont : 0;
+  }
+  printf("%s %d %d %lu %lu %lu %lu %lu\n", kind < 0 ? "fsread" : kinds[kind], nprocs, n,
+         total / 10, (uint64)nprocs * n * 10000 / total,
+         first > t0 ? (first - t0) / 10 : 0, ncont, mean);
+}
+
+int
+main(int argc, char *argv[])
+{
+  for(int i = 1; i + 1 < argc; i += 2){
+    if(strcmp(argv[i], "-p") == 0)
+      nprocs = atoi(argv[i+1]);
+    else if(strcmp(argv[i], "-n") == 0)
+      iters = atoi(argv[i+1]);
+    else if(strcmp(argv[i], "-w") == 0)
+      work = atoi(argv[i+1]);
+    else
+      break;
+  }
+  if(nprocs <= 0 || nprocs > 32 || iters <= 0 || iters > LOCKBENCH_MAXITERS ||
+     work < 0 || work > LOCKBENCH_MAXWORK){
+    fprintf(2, "usage: lockbench [-p procs(1-32)] [-n iters(1-%d)] [-w work(0-%d)]\n",
+            LOCKBENCH_MAXITERS, LOCKBENCH_MAXWORK);
+    exit(1);
+  }
+
+  printf("# kind procs iters total_us ops_per_ms first_us contended mean_spin\n");
+  bench(LOCK_TAS);
+  bench(LOCK_TICKET);
+  bench(LOCK_MCS);
+
+  char buf[512];
+  int fd = open("lockbench.tmp", O_CREATE | O_WRONLY | O_TRUNC);
+  memset(buf, 'x', sizeof(buf));
+  if(fd < 0 || write(fd, buf, sizeof(buf)) != sizeof(buf)){
+    fprintf(2, "lockbench: cannot create lockbench.tmp\n");
+    exit(1);
+  }
+  close(fd);
+  bench(-1);
+  unlink("lockbench.tmp");
+  exit(0);
+}
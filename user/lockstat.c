@@ -0,0 +1,92 @@
+#include "kernel/types.h"
+#include "kernel/stat.h"
+#include "kernel/param.h"
+#include "user/user.h"
+
+// lockstat [-n count] [command [args...]]
+// print the most contended spinlock classes (all the locks
+// initialized with one name): acquisitions, how many had to
+// spin, cycles spent spinning, mean spin per contended
+// acquisition, and the longest hold. A sleeplock's class (buffer,
+// inode, ...) also has its acquiresleep() calls, how many spun
+// while the holder ran and how many queued and slept, and the
+// mean cycles spent in acquiresleep(). With
+// a command, print what changed while it ran; the longest hold is
+// still the longest since boot.
+
+struct lockstat before[NLOCKCLASS], after[NLOCKCLASS];
+
+void
+print(struct lockstat *st, int n, int count)
+{
+  char done[NLOCKCLASS];
+
+  memset(done, 0, sizeof(done));
+  printf("lock acquires contended spin_cycles mean_spin maxhold_cycles sleepacq spun slept mean_wait_us\n");
+  for(int k = 0; k < count; k++){
+    int best = -1;
+    for(int i = 0; i < n; i++)
+      if(!done[i] && (best < 0 || st[i].ncontended > st[best].ncontended))
+        best = i;
+    if(best < 0 || st[best].nacquire == 0)
+      break;
+    done[best] = 1;
+    struct lockstat *s = &st[best];
+    printf("%s %lu %lu %lu %lu %lu %lu %lu %lu %lu\n", s->name, s->nacquire, s->ncontended,
+           s->spin, s->ncontended ? s->spin / s->ncontended : 0, s->maxhold,
+           s->nsleepacq, s->nspun, s->nslept, s->nsleepacq ? s->wait / s->nsleepacq / 10 : 0);
+  }
+}
+
+int
+main(int argc, char *argv[])
+{
+  int count = 10, i = 1, n0 = 0, n;
+
+  if(argc > 2 && strcmp(argv[1], "-n") == 0){
+    count = atoi(argv[2]);
+    i = 3;
+  }
+  if(count <= 0){
+    fprintf(2, "usage: lockstat [-n count] [command [args...]]\n");
+    exit(1);
+  }
+
+  if(i < argc){
+    n0 = getlockstat(before, NLOCKCLASS);
+    int pid = fork();
+    if(pid < 0){
+      fprintf(2, "lockstat: fork failed\n");
+      exit(1);
+    }
+    if(pid == 0){
+      exec(argv[i], argv + i);
+      fprintf(2, "lockstat: exec %s failed\n", argv[i]);
+      exit(1);
+    }
+    wait(0);
+  }
+
+  if((n = getlockstat(after, NLOCKCLASS)) < 0){
+    fprintf(2, "lockstat: getlockstat failed\n");
+    exit(1);
+  }
+  // subtract the counts from before the command, matching
+  // classes by name since the order changes.
+  for(int j = 0; j < n; j++){
+    for(int k = 0; k < n0; k++){
+      if(strcmp(after[j].name, before[k].name) == 0){
+        after[j].nacquire -= before[k].nacquire;
+        after[j].ncontended -= before[k].ncontended;
+        after[j].spin -= before[k].spin;
+        after[j].nsleepacq -= before[k].nsleepacq;
+        after[j].nspun -= before[k].nspun;
+        after[j].nslept -= before[k].nslept;
+        after[j].wait -= before[k].wait;
+        break;
+      }
+    }
+  }
+  print(after, n, count);
+  exit(0);
+}
@@ -0,0 +1,26 @@
+#include "kernel/types.h"
+#include "kernel/stat.h"
+#include "user/user.h"
+
+// nice [-n inc] command [args...]
+// run command with its nice value raised by inc (default 10).
+int
+main(int argc, char *argv[])
+{
+  int inc = 10;
+  int i = 1;
+
+  if(argc > 2 && strcmp(argv[1], "-n") == 0){
+    inc = argv[2][0] == '-' ? -atoi(argv[2] + 1) : atoi(argv[2]);
+    i = 3;
+  }
+  if(i >= argc){
+    fprintf(2, "usage: nice [-n inc] command [args...]\n");
+    exit(1);
+  }
+
+  nice(inc);
+  exec(argv[i], argv + i);
+  fprintf(2, "nice: exec %s failed\n", argv[i]);
+  exit(1);
+}
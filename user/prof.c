@@ -0,0 +1,103 @@
+#include "kernel/types.h"
+#include "kernel/stat.h"
+#include "kernel/fcntl.h"
+#include "kernel/schedctl.h"
+#include "user/user.h"
+
+// prof [-i interval_us] command [args...]
+// run command with the sampling profiler on, printing each
+// sample as
+//   P cpu pid name mode pc ra...
+// (mode u or k, addresses in hex, innermost first) for
+// prof-fold.py on the host to turn into folded stacks.
+
+struct profsample buf[64];
+
+// Print and remove the samples the kernel has buffered.
+int
+drain(void)
+{
+  int n, total = 0;
+
+  while((n = getprofile(buf, 64)) > 0){
+    for(int i = 0; i < n; i++){
+      struct profsample *s = &buf[i];
+      printf("P %d %d %s %c %lx", s->cpu, s->pid, s->name[0] ? s->name : "-",
+             s->user ? 'u' : 'k', s->pc);
+      for(int j = 0; j < PROFDEPTH && s->stack[j]; j++)
+        printf(" %lx", s->stack[j]);
+      printf("\n");
+    }
+    total += n;
+  }
+  return total;
+}
+
+// Copy the profile line of /proc/schedstat, with the
+// count of samples lost to full buffers.
+void
+print_dropped(void)
+{
+  char line[512];
+  int fd, n;
+
+  if((fd = open("/proc/schedstat", O_RDONLY)) < 0)
+    return;
+  n = read(fd, line, sizeof(line) - 1);
+  close(fd);
+  if(n <= 0)
+    return;
+  line[n] = 0;
+  for(char *s = line; s && *s; s = strchr(s, '\n') ? strchr(s, '\n') + 1 : 0){
+    if(memcmp(s, "profile ", 8) == 0){
+      char *e = strchr(s, '\n');
+      if(e)
+        *e = 0;
+      printf("# %s\n", s);
+      return;
+    }
+  }
+}
+
+int
+main(int argc, char *argv[])
+{
+  struct procinfo info;
+  int interval = 5000, i = 1, n = 0;
+
+  if(argc > 2 && strcmp(argv[1], "-i") == 0){
+    interval = atoi(argv[2]);
+    i = 3;
+  }
+  if(i >= argc || interval < PROF_MIN_US){
+    fprintf(2, "usage: prof [-i interval_us] command [args...]\n"
+               "interval_us must be at least %d\n", PROF_MIN_US);
+    exit(1);
+  }
+
+  drain();   // discard leftovers of an earlier run
+  int pid = fork();
+  if(pid < 0){
+    fprintf(2, "prof: fork failed\n");
+    exit(1);
+  }
+  if(pid == 0){
+    exec(argv[i], argv + i);
+    fprintf(2, "prof: exec %s failed\n", argv[i]);
+    exit(1);
+  }
+
+  schedctl(SCHEDCTL_PROFILE, interval);
+  // drain well before a CPU's buffer (128 samples) fills.
+  while(getprocinfo(pid, &info) == 0 && info.state != ZOMBIE){
+    nanosleep(200000);   // 20 ms
+    n += drain();
+  }
+  schedctl(SCHEDCTL_PROFILE, 0);
+  n += drain();
+  wait(0);
+
+  printf("# %d samples every %d us\n", n, interval);
+  print_dropped();
+  exit(0);
+}
@@ -0,0 +1,277 @@
+#include "kernel/types.h"
+#include "kernel/stat.h"
+#include "kernel/fcntl.h"
+#include "user/user.h"
+
+// schedbench [-n iters] [test...]
+// scheduler microbenchmarks, timed with gettime() (10MHz clock,
+// 100 ns resolution, read in user mode). Prints one line per test,
+//   test iters mean_ns p50_ns p99_ns min_ns max_ns
+// for comparing policies and kernel changes with a script.
+// The gettime line is the cost of taking a timestamp, which is
+// included in every other result.
+
+#define MAXITERS 2000
+
+int iters = 200;
+uint64 sample[MAXITERS];
+
+// Sort the first n samples (shell sort).
+void
+sort(int n)
+{
+  for(int gap = n / 2; gap > 0; gap /= 2){
+    for(int i = gap; i < n; i++){
+      uint64 v = sample[i];
+      int j;
+      for(j = i; j >= gap && sample[j - gap] > v; j -= gap)
+        sample[j] = sample[j - gap];
+      sample[j] = v;
+    }
+  }
+}
+
+// Print the samples in ns; 10MHz clock: 100 ns per unit.
+void
+report(char *name, int n)
+{
+  uint64 sum = 0;
+
+  if(n == 0){
+    printf("%s 0 0 0 0 0 0\n", name);
+    return;
+  }
+  for(int i = 0; i < n; i++)
+    sum += sample[i];
+  sort(n);
+  printf("%s %d %lu %lu %lu %lu %lu\n", name, n,
+         sum * 100 / n, sample[n / 2] * 100, sample[(n * 99) / 100] * 100,
+         sample[0] * 100, sample[n - 1] * 100);
+}
+
+void
+bench_gettime(void)
+{
+  for(int i = 0; i < iters; i++){
+    uint64 t0 = gettime();
+    sample[i] = gettime() - t0;
+  }
+  report("gettime", iters);
+}
+
+// the same clock through a system call: the cost of a trap.
+void
+bench_sys_gettime(void)
+{
+  for(int i = 0; i < iters; i++){
+    uint64 t0 = gettime();
+    sys_gettime();
+    sample[i] = gettime() - t0;
+  }
+  report("sys_gettime", iters);
+}
+
+// yield() round trip through the scheduler.
+void
+bench_yield(void)
+{
+  for(int i = 0; i < iters; i++){
+    uint64 t0 = gettime();
+    yield();
+    sample[i] = gettime() - t0;
+  }
+  report("yield", iters);
+}
+
+// One byte there and back over a pair of pipes: two wakeups
+// and at least two context switches.
+void
+bench_pipe(void)
+{
+  int ping[2], pong[2];
+  char c = 0;
+  int n = 0;
+
+  if(pipe(ping) < 0 || pipe(pong) < 0){
+    fprintf(2, "schedbench: pipe failed\n");
+    exit(1);
+  }
+  int pid = fork();
+  if(pid < 0){
+    fprintf(2, "schedbench: fork failed\n");
+    exit(1);
+  }
+  if(pid == 0){
+    close(ping[1]);
+    close(pong[0]);
+    while(read(ping[0], &c, 1) == 1)
+      write(pong[1], &c, 1);
+    exit(0);
+  }
+  close(ping[0]);
+  close(pong[1]);
+  for(; n < iters; n++){
+    uint64 t0 = gettime();
+    if(write(ping[1], &c, 1) != 1 || read(pong[0], &c, 1) != 1)
+      break;
+    sample[n] = gettime() - t0;
+  }
+  close(ping[1]);
+  close(pong[0]);
+  wait(0);
+  report("pipe", n);
+}
+
+// Time from the write that wakes a process blocked in read()
+// to that process running: the child stamps the time it was
+// woken and sends back the difference.
+void
+bench_wakeup(void)
+{
+  int go[2], back[2];
+  uint64 t;
+  int n = 0;
+
+  if(pipe(go) < 0 || pipe(back) < 0){
+    fprintf(2, "schedbench: pipe failed\n");
+    exit(1);
+  }
+  int pid = fork();
+  if(pid < 0){
+    fprintf(2, "schedbench: fork failed\n");
+    exit(1);
+  }
+  if(pid == 0){
+    close(go[1]);
+    close(back[0]);
+    while(read(go[0], &t, sizeof(t)) == sizeof(t)){
+      t = gettime() - t;
+      write(back[1], &t, sizeof(t));
+    }
+    exit(0);
+  }
+  close(go[0]);
+  close(back[1]);
+  for(; n < iters; n++){
+    // let the child get back to sleep in read().
+    yield();
+    t = gettime();
+    if(write(go[1], &t, sizeof(t)) != sizeof(t) ||
+       read(back[0], &t, sizeof(t)) != sizeof(t))
+      break;
+    sample[n] = t;
+  }
+  close(go[1]);
+  close(back[0]);
+  wait(0);
+  report("wakeup", n);
+}
+
+// fork(), child exit(), parent wait().
+void
+bench_fork(void)
+{
+  int n = 0;
+
+  for(; n < iters; n++){
+    uint64 t0 = gettime();
+    int pid = fork();
+    if(pid < 0)
+      break;
+    if(pid == 0)
+      exit(0);
+    wait(0);
+    sample[n] = gettime() - t0;
+  }
+  report("fork", n);
+}
+
+// fork(), child exec()s this program to exit at once, parent wait().
+void
+bench_exec(void)
+{
+  char *argv[] = { "schedbench", "-x", 0 };
+  int n = 0;
+
+  for(; n < iters; n++){
+    uint64 t0 = gettime();
+    int pid = fork();
+    if(pid < 0)
+      break;
+    if(pid == 0){
+      exec(argv[0], argv);
+      fprintf(2, "schedbench: exec failed\n");
+      exit(1);
+    }
+    wait(0);
+    sample[n] = gettime() - t0;
+  }
+  report("exec", n);
+}
+
+struct test {
+  char *name;
+  void (*fn)(void);
+} tests[] = {
+  { "gettime",     bench_gettime },
+  { "sys_gettime", bench_sys_gettime },
+  { "yield",       bench_yield },
+  { "pipe",        bench_pipe },
+  { "wakeup",      bench_wakeup },
+  { "fork",        bench_fork },
+  { "exec",        bench_exec },
+  { 0, 0 },
+};
+
+// Print the "policy X" line of /proc/schedstat.
+void
+print_policy(void)
+{
+  char buf[32];
+  int fd, n;
+
+  if((fd = open("/proc/schedstat", O_RDONLY)) < 0)
+    return;
+  n = read(fd, buf, sizeof(buf) - 1);
+  close(fd);
+  if(n <= 0)
+    return;
+  buf[n] = 0;
+  char *nl = strchr(buf, '\n');
+  if(nl)
+    *nl = 0;
+  printf("# %s\n", buf);
+}
+
+int
+main(int argc, char *argv[])
+{
+  struct test *t;
+  int i = 1;
+
+  if(argc > 1 && strcmp(argv[1], "-x") == 0)
+    exit(0);   // bench_exec's child
+  if(argc > 2 && strcmp(argv[1], "-n") == 0){
+    iters = atoi(argv[2]);
+    if(iters <= 0 || iters > MAXITERS){
+      fprintf(2, "schedbench: iters must be 1..%d\n", MAXITERS);
+      exit(1);
+    }
+    i = 3;
+  }
+
+  print_policy();
+  printf("# test iters mean_ns p50_ns p99_ns min_ns max_ns\n");
+  for(t = tests; t->name; t++){
+    if(i < argc){
+      int j;
+      for(j = i; j < argc; j++)
+        if(strcmp(argv[j], t->name) == 0)
+          break;
+      if(j == argc)
+        continue;
+    }
+    t->fn();
+  }
+  exit(0);
+}
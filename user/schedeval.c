@@ -1,274 +1,218 @@
-#include "user.h"
-void work(int ticks)
-{
-    for (int i = 0; i < ticks; i++)
-    {
-        yield();  
-    }
-}
+#include "kernel/types.h"
+#include "user/user.h"
+#include "user/workload.h"
 
 uint64 MICROSECONDS = 10;
 uint64  MILLISECONDS = 10000;
 uint64  scale;
 
-void print_info(int pid){
-    struct procinfo info;
+// Print the timing of a child reaped with waitx(). Taking it at
+// reap time (rather than from the child before it exits) means
+// etime and rtime are final.
+void print_info(struct procinfo *info){
     scale = MICROSECONDS;
     char units[] = "µs";
     if(scale == MILLISECONDS){
         strcpy(units, "ms");
     }
-   
-    if(getprocinfo(pid, &info) == 0){
-        uint64 tat = (info.etime - info.ctime)/scale;            // turnaround time
-        uint64 wt  = ((info.etime - info.ctime) - info.rtime)/scale;                  // waiting time
-        uint64 rt  = (info.stime - info.ctime)/scale;           // response time
-        printf("pid: %d, ctime (creation time): %lu, stime (start time): %lu, rtime (runtime): %lu, etime (exit time): %lu, priority: %d, name: %s\n",
-            info.pid, info.ctime/scale, info.stime/scale, info.rtime/scale, info.etime/scale, info.priority, info.name);
-        printf("turnaround time %lu %s, waiting time %lu %s, response time %lu %s \n", tat, units, wt, units, rt, units);
-        printf("\n");
-        } else {
-            printf("failed to get proc info for pid %d\n", pid);
-        }
-}
 
-void wait_for_all_children(void) {
-    while (wait(0) > 0)
-        ; // keep waiting until no more children exist
+    uint64 tat = (info->etime - info->ctime)/scale;            // turnaround time
+    uint64 wt  = info->wtime/scale;                            // waiting time (runnable, not running)
+    uint64 rt  = (info->stime - info->ctime)/scale;           // response time
+    printf("pid: %d, ctime (creation time): %lu, stime (start time): %lu, rtime (runtime): %lu, etime (exit time): %lu, priority: %d, name: %s\n",
+        info->pid, info->ctime/scale, info->stime/scale, info->rtime/scale, info->etime/scale, info->priority, info->name);
+    printf("turnaround time %lu %s, waiting time %lu %s, response time %lu %s \n", tat, units, wt, units, rt, units);
+    printf("user %lu %s, system %lu %s, sleep %lu %s, context switches %lu voluntary %lu involuntary\n",
+        info->utime/scale, units, info->ktime/scale, units, info->slptime/scale, units, info->nvcsw, info->nivcsw);
+    printf("\n");
 }
 
-//Same as the accuracy test suite, sanity check that timings are working 
-int sanity_check()
-{
-    printf("\n=== SANITY CHECK ===\n");
-
-    int p_long = fork();
-    if (p_long == 0)
-    {
-        setexpected(200);
-        work(200);
-        int pid = getpid();
-        printf("LONG done (pid=%d)\n", pid);
-        print_info(pid);
-        exit(0);
-    }
+// schedeval -r: also report scheduler statistics for each
+// child, and totals for each test.
+int report;
+struct procinfo totals;
 
-    for (volatile int i = 0; i < 3000000; i++)
-        ; // small delay
+void print_stats(char *who, struct procinfo *info){
+    printf("%s: switches %lu voluntary %lu involuntary, migrations %lu, mlfq promotions %lu demotions %lu aging boosts %lu\n",
+        who, info->nvcsw, info->nivcsw, info->nmigrate, info->npromote, info->ndemote, info->nboost);
+}
 
-    int p_short = fork();
-    if (p_short == 0)
-    {
-        setexpected(20);
-        work(20);
-        int pid = getpid();
-        printf("SHORT done (pid=%d)\n", pid);
-        print_info(pid);
-        exit(0);
-    }
-    wait(0);
-    wait(0);
-    return 0;
+// Print and clear the totals of the children reaped so far.
+void print_report(void){
+    if(!report)
+        return;
+    print_stats("all children", &totals);
+    memset(&totals, 0, sizeof(totals));
 }
 
-//Adversarial to Round Robin
-int eval1()
+// Reap one child, printing its timing. Returns its pid.
+int reap(void)
 {
-    printf("\n=== TEST 1: MANY SHORT + ONE LONG WITHIN ===\n");
-
-    // Define runtimes
-    int rt[5] = {20, 20, 500, 20, 20};
-    int pid[5];
-
-    // Fork all processes
-    for (int i = 0; i < 5; i++)
-    {
-        pid[i] = fork();
-        if (pid[i] == 0)
-        {
-            // Required for STCF & SJF
-            setexpected(rt[i]);
-
-            // Required for STCF
-            setstcfvals(rt[i]);
-
-            // Simulated CPU work
-            work(rt[i]);
-
-            // Identify short vs long
-            if (rt[i] < 100)
-                printf("Child %d (pid=%d) SHORT job rt=%d done\n", i, getpid(), rt[i]);
-            else
-                printf("Child %d (pid=%d) LONG job rt=%d done\n", i, getpid(), rt[i]);
-
-            // Print timing info
-            print_info(getpid());
-
-            exit(0);
+    struct procinfo info;
+    int pid = waitx(0, &info);
+    if(pid > 0){
+        print_info(&info);
+        if(report){
+            print_stats(info.name, &info);
+            printf("\n");
+            totals.nvcsw += info.nvcsw;
+            totals.nivcsw += info.nivcsw;
+            totals.nmigrate += info.nmigrate;
+            totals.npromote += info.npromote;
+            totals.ndemote += info.ndemote;
+            totals.nboost += info.nboost;
         }
     }
-
-    // Parent: collect completion order
-    int finish[5];
-    for (int i = 0; i < 5; i++)
-        finish[i] = wait(0);
-
-    printf("\n=== COMPLETION ORDER ===\n");
-    for (int i = 0; i < 5; i++)
-        printf("%d ", finish[i]);
-    printf("\n");
-
-    // printf("\nExpected order for SJF/STCF:\n");
-    // printf("20 → 25 → 30 → 35 → 40 → 500\n\n");
-    return 0;
+    return pid;
 }
 
+void wait_for_all_children(void) {
+    while (wait(0) > 0)
+        ; // keep waiting until no more children exist
+}
 
-// Adversarial to FIFO
-// ------------------------------------------------------------
-// TEST X: LONG JOB FIRST, THEN MANY SHORT JOBS
-// One very long job starts, then several short jobs arrive later
-
-// Expected completion (FIFO): long job first 
-// Expected completion (SJF/STCF): short jobs first → long job last
-// 
-// ------------------------------------------------------------
-int eval2()
+// The scenarios, as data for wl_run(). CPU phases are calibrated
+// spin loops, so jobs are preempted by the timer like real
+// computation instead of yielding.
+struct scenario scenarios[] = {
+    // Same as the accuracy test suite, sanity check that timings are working
+    { "sanity", "SANITY CHECK", WL_FIXED, 0, 0, {
+        { "LONG",  0,  200, 0, { { W_CPU, 200 } } },
+        { "SHORT", 30, 20,  0, { { W_CPU, 20 } } },
+    } },
+    // Adversarial to Round Robin
+    { "short", "MANY SHORT + ONE LONG WITHIN", WL_FIXED, 0, 0, {
+        { "SHORT 0", 0, 20,  0, { { W_CPU, 20 } } },
+        { "SHORT 1", 0, 20,  0, { { W_CPU, 20 } } },
+        { "LONG",    0, 500, 0, { { W_CPU, 500 } } },
+        { "SHORT 2", 0, 20,  0, { { W_CPU, 20 } } },
+        { "SHORT 3", 0, 20,  0, { { W_CPU, 20 } } },
+    } },
+    // Adversarial to FIFO: one very long job starts, then several
+    // short jobs arrive. FIFO finishes the long job first; SJF/STCF
+    // finish the short jobs first.
+    { "convoy", "LONG THEN MANY SHORT JOBS", WL_FIXED, 0, 0, {
+        { "LONG",    0,  500, 0, { { W_CPU, 500 } } },
+        { "SHORT 0", 50, 20,  0, { { W_CPU, 20 } } },
+        { "SHORT 1", 0,  20,  0, { { W_CPU, 20 } } },
+        { "SHORT 2", 0,  20,  0, { { W_CPU, 20 } } },
+        { "SHORT 3", 0,  20,  0, { { W_CPU, 20 } } },
+    } },
+    // Continuous stream of very short jobs: the long job is delayed
+    // until the shorts stop under SJF/STCF, unless aging kicks in.
+    { "starve", "STARVATION OF LONG JOB", WL_FIXED, 0, 0, {
+        { "LONG",    0,  500, 0, { { W_CPU, 500 } } },
+        { "SHORT 0", 30, 10,  0, { { W_CPU, 10 } } },
+        { "SHORT 1", 10, 10,  0, { { W_CPU, 10 } } },
+        { "SHORT 2", 10, 10,  0, { { W_CPU, 10 } } },
+        { "SHORT 3", 10, 10,  0, { { W_CPU, 10 } } },
+        { "SHORT 4", 10, 10,  0, { { W_CPU, 10 } } },
+        { "SHORT 5", 10, 10,  0, { { W_CPU, 10 } } },
+    } },
+    // An interactive job that computes briefly between sleeps,
+    // next to CPU hogs. MLFQ should keep its response time low.
+    { "interactive", "INTERACTIVE JOB AMONG CPU HOGS", WL_FIXED, 0, 0, {
+        { "HOG 0", 0, 1000, 0, { { W_CPU, 1000 } } },
+        { "HOG 1", 0, 1000, 0, { { W_CPU, 1000 } } },
+        { "EDITOR", 10, 25, 0, { { W_CPU, 5 }, { W_SLEEP, 1 }, { W_CPU, 5 }, { W_SLEEP, 1 },
+                                 { W_CPU, 5 }, { W_SLEEP, 1 }, { W_CPU, 5 }, { W_SLEEP, 1 },
+                                 { W_CPU, 5 } } },
+    } },
+    // Jobs alternating computation with file and pipe I/O.
+    { "iomix", "CPU, DISK AND PIPE I/O MIX", WL_FIXED, 0, 0, {
+        { "CPU",  0, 400, 0, { { W_CPU, 400 } } },
+        { "DISK", 0, 60,  0, { { W_CPU, 20 }, { W_DISK, 32 }, { W_CPU, 20 }, { W_DISK, 32 },
+                               { W_CPU, 20 } } },
+        { "PIPE", 0, 60,  0, { { W_CPU, 20 }, { W_PIPE, 64 }, { W_CPU, 20 }, { W_PIPE, 64 },
+                               { W_CPU, 20 } } },
+        { "NICE", 0, 200, 10, { { W_CPU, 200 } } },
+    } },
+    // Poisson arrivals, mean 100 ms apart, of mixed job sizes.
+    { "poisson", "POISSON ARRIVALS", WL_POISSON, 100, 0, {
+        { "A", 0, 150, 0, { { W_CPU, 150 } } },
+        { "B", 0, 30,  0, { { W_CPU, 30 } } },
+        { "C", 0, 300, 0, { { W_CPU, 300 } } },
+        { "D", 0, 60,  0, { { W_CPU, 30 }, { W_DISK, 16 }, { W_CPU, 30 } } },
+        { "E", 0, 20,  0, { { W_CPU, 20 } } },
+        { "F", 0, 100, 0, { { W_CPU, 100 } } },
+        { "G", 0, 40,  0, { { W_CPU, 20 }, { W_SLEEP, 1 }, { W_CPU, 20 } } },
+        { "H", 0, 200, 0, { { W_CPU, 200 } } },
+    } },
+    // Groups of three jobs arriving together, 300 ms apart on average.
+    { "bursty", "BURSTY ARRIVALS", WL_BURSTY, 300, 3, {
+        { "A", 0, 100, 0, { { W_CPU, 100 } } },
+        { "B", 0, 20,  0, { { W_CPU, 20 } } },
+        { "C", 0, 50,  0, { { W_CPU, 50 } } },
+        { "D", 0, 200, 0, { { W_CPU, 200 } } },
+        { "E", 0, 20,  0, { { W_CPU, 20 } } },
+        { "F", 0, 20,  0, { { W_CPU, 20 } } },
+        { "G", 0, 80,  0, { { W_CPU, 40 }, { W_PIPE, 16 }, { W_CPU, 40 } } },
+        { "H", 0, 10,  0, { { W_CPU, 10 } } },
+        { "I", 0, 300, 0, { { W_CPU, 300 } } },
+    } },
+    { 0 },
+};
+
+// Run scenario s and reap its jobs, printing the completion order.
+void run(struct scenario *s)
 {
-    printf("\n=== TEST 2: LONG THEN MANY SHORT JOBS ===\n");
+    int pids[WL_MAXJOB];
 
-    // Start the long job first
-    int p_long = fork();
-    if (p_long == 0)
-    {
-        setexpected(500);
-        setstcfvals(500);
-        work(500);
-        int pid = getpid();
-        printf("LONG done (pid=%d)\n", pid);
-        // Print timing info
-        print_info(pid);
-        exit(0);
-    }
+    printf("\n=== %s ===\n", s->desc);
+    int n = wl_run(s, pids);
 
-    // Delay before launching short jobs
-    for (volatile int i = 0; i < 5000000; i++)
-        ;
-
-    int p_short[4];
-    int runtimes[4] = {20, 20, 20, 20};
-
-    // Launch several short jobs afterward
-    for (int i = 0; i < 4; i++)
-    {
-        p_short[i] = fork();
-        if (p_short[i] == 0)
-        {
-            setexpected(runtimes[i]);
-            setstcfvals(runtimes[i]);
-            work(runtimes[i]);
-            int pid = getpid();
-            printf("SHORT %d done (pid=%d)\n", i, pid);
-            // Print timing info
-            print_info(pid);
-            exit(0);
-        }
-    }
+    int finish[WL_MAXJOB];
+    for (int i = 0; i < n; i++)
+        finish[i] = reap();
 
-    // Collect completion order
-    int finish[5];
-    for (int i = 0; i < 5; i++)
-        finish[i] = wait(0);
-
-    printf("Finish order:\n");
-    for (int i = 0; i < 5; i++)
+    printf("\n=== COMPLETION ORDER ===\n");
+    for (int i = 0; i < n; i++)
         printf("%d ", finish[i]);
     printf("\n");
 
-    return 0;
+    wait_for_all_children();
+    print_report();
 }
 
+// schedeval [-r] [-s seed] [scenario...]
+// run the named scenarios, or the first three.
+int main(int argc, char *argv[]) {
+    struct scenario *s;
+    uint64 seed = 1;
+    int i = 1;
+
+    for (; i < argc && argv[i][0] == '-'; i++) {
+        if (strcmp(argv[i], "-r") == 0)
+            report = 1;
+        else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+            seed = atoi(argv[++i]);
+        else {
+            fprintf(2, "usage: schedeval [-r] [-s seed] [scenario...]\n");
+            exit(1);
+        }
+    }
 
-// ------------------------------------------------------------
-// TEST X: STARVATION OF LONG JOB
-// Continuous stream of very short jobs, long job should starve
-// Expected behavior:
-//   - Long job gets delayed until shorts stop (STCF/SJF)
-//   - Demonstrates need for priority boost or MLFQ
-// ------------------------------------------------------------
-int eval3()
-{
-    printf("\n=== TEST 3: STARVATION OF LONG JOB ===\n");
+    wl_seed(seed);
+    wl_calibrate();
+    printf("seed %lu\n", seed);
 
-    // Create the long job first
-    int p_long = fork();
-    if (p_long == 0)
-    {
-        setexpected(500);    // Long job
-        setstcfvals(500);
-        work(500);           // Simulated CPU work
-        printf("LONG done (pid=%d)\n", getpid());
-        print_info(getpid());
+    if (i == argc) {
+        for (s = scenarios; s < &scenarios[3]; s++)
+            run(s);
         exit(0);
     }
-
-    // Delay a little before starting the short job stream
-    for (volatile int i = 0; i < 3000000; i++)
-        ;
-
-    // Launch a continuous stream of short jobs
-    const int N_SHORT = 6;
-    int rt[] = {10, 10, 10, 10, 10, 10};
-    int pid_short[N_SHORT];
-
-    for (int i = 0; i < N_SHORT; i++)
-    {
-        pid_short[i] = fork();
-        if (pid_short[i] == 0)
-        {
-            setexpected(rt[i]);
-            setstcfvals(rt[i]);
-            work(rt[i]);
-            printf("SHORT %d done (pid=%d)\n", i, getpid());
-            print_info(getpid());
-            exit(0);
+    for (; i < argc; i++) {
+        for (s = scenarios; s->name; s++)
+            if (strcmp(s->name, argv[i]) == 0)
+                break;
+        if (s->name == 0) {
+            fprintf(2, "schedeval: unknown scenario %s; have", argv[i]);
+            for (s = scenarios; s->name; s++)
+                fprintf(2, " %s", s->name);
+            fprintf(2, "\n");
+            exit(1);
         }
-
-        // Small delay between short job arrivals to simulate "continuous" arrival
-        for (volatile int j = 0; j < 1000000; j++)
-            ;
+        run(s);
     }
-
-    // Parent waits for all jobs
-    int finish[N_SHORT + 1];
-    finish[0] = wait(0); // long job or first short (depending on scheduler)
-    for (int i = 1; i <= N_SHORT; i++)
-        finish[i] = wait(0);
-
-    printf("\nCompletion order:\n");
-    for (int i = 0; i <= N_SHORT; i++)
-        printf("%d ", finish[i]);
-    printf("\n");
-
-    printf("Expected (SJF/STCF): short jobs first, long job last\n");
-    printf("Demonstrates starvation of long job in STCF/SJF & MLFQ\n\n");
-
-    return 0;
-}
-
-
-
-int main() {
-   sanity_check();
-   wait_for_all_children();
-
-   eval1();
-   wait_for_all_children();
-
-   eval2();
-   wait_for_all_children();
-
-
-
-   exit(0);
+    exit(0);
 }
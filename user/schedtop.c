@@ -0,0 +1,69 @@
+#include "kernel/types.h"
+#include "kernel/stat.h"
+#include "kernel/param.h"
+#include "kernel/statspage.h"
+#include "user/user.h"
+
+// schedtop [n]
+// print n snapshots (default 1), one per clock tick, of the
+// process table and CPU load, read from the statistics page
+// that mapstats() maps in rather than with system calls.
+
+static char *states[] = {
+  "unused", "used", "sleep ", "runble", "run   ", "zombie"
+};
+
+struct statspage snap;
+
+// Copy a consistent snapshot of the page into snap.
+void
+sample(struct statspage *sp)
+{
+  uint seq;
+
+  do {
+    while((seq = sp->seq) & 1)
+      ;
+    __sync_synchronize();
+    memmove(&snap, (void *)sp, sizeof(snap));
+    __sync_synchronize();
+  } while(sp->seq != seq);
+}
+
+int
+main(int argc, char *argv[])
+{
+  struct statspage *sp;
+  int n = argc > 1 ? atoi(argv[1]) : 1;
+
+  if((sp = mapstats()) == (void *)-1){
+    fprintf(2, "schedtop: mapstats failed\n");
+    exit(1);
+  }
+
+  for(int i = 0; i < n; i++){
+    if(i > 0)
+      pause(1);
+    sample(sp);
+    printf("time %lu ms, %d runnable\n", snap.time / 10000, snap.nrunnable);
+    for(int c = 0; c < NCPU; c++){
+      struct statscpu *cs = &snap.cpu[c];
+      uint64 total = cs->busy + cs->idle + cs->sched;
+      if(total == 0)
+        continue;
+      printf("cpu %d: pid %d, busy %lu%%, %lu switches\n",
+             c, cs->pid, cs->busy * 100 / total, cs->nswitch);
+    }
+    printf("pid\tstate\tlevel\tnice\trtime(ms)\tname\n");
+    for(int p = 0; p < NPROC; p++){
+      struct statsproc *ps = &snap.proc[p];
+      if(ps->pid == 0)
+        continue;
+      printf("%d\t%s\t%d\t%d\t%lu\t\t%s\n", ps->pid,
+             ps->state >= 0 && ps->state < 6 ? states[ps->state] : "???",
+             ps->queue_level, ps->priority, ps->rtime / 10000, ps->name);
+    }
+    printf("\n");
+  }
+  exit(0);
+}
@@ -0,0 +1,48 @@
+#include "kernel/types.h"
+#include "kernel/stat.h"
+#include "kernel/schedctl.h"
+#include "user/user.h"
+
+// schedtune [name [value]]
+// print or set the scheduler tunables in kernel/schedctl.h.
+
+struct tunable {
+  char *name;
+  int param;
+} tunables[] = {
+  { "interact", SCHEDCTL_INTERACT },
+  { "starve", SCHEDCTL_STARVE },
+  { "aging", SCHEDCTL_AGING },
+  { "profile", SCHEDCTL_PROFILE },
+  { "systime", SCHEDCTL_SYSTIME },
+  { "strace", SCHEDCTL_STRACE },
+  { 0, 0 },
+};
+
+int
+main(int argc, char *argv[])
+{
+  struct tunable *t;
+
+  for(t = tunables; t->name; t++){
+    if(argc > 1 && strcmp(argv[1], t->name) != 0)
+      continue;
+    int val = argc > 2 ? atoi(argv[2]) : -1;
+    int old = schedctl(t->param, val);
+    if(old < 0){
+      fprintf(2, "schedtune: cannot set %s to %s\n", t->name, argv[2]);
+      exit(1);
+    }
+    if(argc > 2)
+      printf("%s: %d -> %d\n", t->name, old, val);
+    else
+      printf("%s: %d\n", t->name, old);
+    if(argc > 1)
+      exit(0);
+  }
+  if(argc > 1){
+    fprintf(2, "schedtune: unknown tunable %s\n", argv[1]);
+    exit(1);
+  }
+  exit(0);
+}
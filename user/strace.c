@@ -0,0 +1,200 @@
+#include "kernel/types.h"
+#include "kernel/stat.h"
+#include "kernel/syscall.h"
+#include "kernel/schedctl.h"
+#include "user/user.h"
+
+// strace command [args...]
+// strace -c command [args...]
+// strace -c [-p pid]
+// print each system call command makes, with its arguments,
+// return value and latency, or with -c a table of its calls'
+// counts and latencies. -c without a command prints the table
+// of process pid, or of all processes, since latency timing was
+// turned on (schedtune systime 1); only the last process traced
+// has percentiles and maximums.
+
+struct sysdesc {
+  char *name;
+  int nargs;
+} calls[NSYSCALL] = {
+  [SYS_fork] { "fork", 0 },
+  [SYS_exit] { "exit", 1 },
+  [SYS_wait] { "wait", 1 },
+  [SYS_pipe] { "pipe", 1 },
+  [SYS_read] { "read", 3 },
+  [SYS_kill] { "kill", 1 },
+  [SYS_exec] { "exec", 2 },
+  [SYS_fstat] { "fstat", 2 },
+  [SYS_chdir] { "chdir", 1 },
+  [SYS_dup] { "dup", 1 },
+  [SYS_getpid] { "getpid", 0 },
+  [SYS_sbrk] { "sbrk", 2 },
+  [SYS_pause] { "pause", 1 },
+  [SYS_uptime] { "uptime", 0 },
+  [SYS_open] { "open", 2 },
+  [SYS_write] { "write", 3 },
+  [SYS_mknod] { "mknod", 3 },
+  [SYS_unlink] { "unlink", 1 },
+  [SYS_link] { "link", 2 },
+  [SYS_mkdir] { "mkdir", 1 },
+  [SYS_close] { "close", 1 },
+  [SYS_setexpected] { "setexpected", 1 },
+  [SYS_setstcfvals] { "setstcfvals", 2 },
+  [SYS_yield] { "yield", 0 },
+  [SYS_getprocinfo] { "getprocinfo", 2 },
+  [SYS_yield_to] { "yield_to", 1 },
+  [SYS_send] { "send", 3 },
+  [SYS_recv] { "recv", 3 },
+  [SYS_nice] { "nice", 1 },
+  [SYS_setpriority] { "setpriority", 2 },
+  [SYS_getpriority] { "getpriority", 1 },
+  [SYS_schedctl] { "schedctl", 2 },
+  [SYS_setpgid] { "setpgid", 2 },
+  [SYS_setquota] { "setquota", 3 },
+  [SYS_getpgroupinfo] { "getpgroupinfo", 2 },
+  [SYS_getwaithist] { "getwaithist", 3 },
+  [SYS_waitx] { "waitx", 2 },
+  [SYS_exitstats] { "exitstats", 2 },
+  [SYS_getcpustats] { "getcpustats", 2 },
+  [SYS_mapstats] { "mapstats", 0 },
+  [SYS_gettime] { "gettime", 0 },
+  [SYS_nanosleep] { "nanosleep", 1 },
+  [SYS_getprofile] { "getprofile", 2 },
+  [SYS_getsysstat] { "getsysstat", 2 },
+  [SYS_getstrace] { "getstrace", 2 },
+  [SYS_getlockstat] { "getlockstat", 2 },
+  [SYS_lockbench] { "lockbench", 3 },
+};
+
+struct straceent ents[32];
+struct hist h[NSYSCALL];
+
+// Remove the buffered trace entries, printing them if print is set.
+void
+drain(int print)
+{
+  int n;
+
+  while((n = getstrace(ents, 32)) > 0){
+    for(int i = 0; i < n && print; i++){
+      struct straceent *e = &ents[i];
+      struct sysdesc *d = &calls[e->num];
+      fprintf(2, "[%d] %s(", e->pid, d->name ? d->name : "?");
+      for(int j = 0; j < d->nargs; j++){
+        if(j > 0)
+          fprintf(2, ", ");
+        if(j == 0 && e->str[0])
+          fprintf(2, "\"%s\"", e->str);
+        else
+          fprintf(2, "0x%lx", e->arg[j]);
+      }
+      if(e->num == SYS_exit)
+        fprintf(2, ")\n");
+      else
+        fprintf(2, ") = %d <%lu us>\n", (int)e->ret, e->dur / 10);
+    }
+  }
+}
+
+// Estimate the p-th percentile of h: the upper bound of the
+// bucket holding it, capped at the largest value seen.
+uint64
+percentile(struct hist *h, int p)
+{
+  uint64 want = (h->count * p + 99) / 100;
+  uint64 seen = 0;
+
+  for(int i = 0; i < NHIST; i++){
+    seen += h->bucket[i];
+    if(seen >= want && seen > 0){
+      uint64 top = i == 0 ? 0 : (1UL << i) - 1;
+      return top < h->max ? top : h->max;
+    }
+  }
+  return h->max;
+}
+
+// Print h[] as a table, most total time first; times in us.
+void
+table(void)
+{
+  char done[NSYSCALL];
+
+  memset(done, 0, sizeof(done));
+  printf("syscall calls total_us mean_us p50_us p99_us max_us\n");
+  for(;;){
+    int best = -1;
+    for(int i = 1; i < NSYSCALL; i++)
+      if(!done[i] && h[i].count > 0 && (best < 0 || h[i].sum > h[best].sum))
+        best = i;
+    if(best < 0)
+      break;
+    done[best] = 1;
+    struct hist *b = &h[best];
+    printf("%s %lu %lu %lu", calls[best].name ? calls[best].name : "?",
+           b->count, b->sum / 10, b->sum / b->count / 10);
+    uint64 nb = 0;
+    for(int i = 0; i < NHIST; i++)
+      nb += b->bucket[i];
+    if(nb == 0)   // count and sum only
+      printf(" - - -\n");
+    else
+      printf(" %lu %lu %lu\n", percentile(b, 50) / 10, percentile(b, 99) / 10, b->max / 10);
+  }
+}
+
+int
+main(int argc, char *argv[])
+{
+  struct procinfo info;
+  int count = 0, pid = 0, i = 1;
+
+  if(i < argc && strcmp(argv[i], "-c") == 0){
+    count = 1;
+    i++;
+  }
+  if(count && i + 1 < argc && strcmp(argv[i], "-p") == 0){
+    pid = atoi(argv[i+1]);
+    i += 2;
+  }
+  if(i == argc && count){
+    if(getsysstat(pid, h) < 0){
+      fprintf(2, "strace: no process %d\n", pid);
+      exit(1);
+    }
+    table();
+    exit(0);
+  }
+  if(i == argc || pid){
+    fprintf(2, "usage: strace [-c] command [args...] | strace -c [-p pid]\n");
+    exit(1);
+  }
+
+  drain(0);   // discard leftovers of an earlier run
+
+  pid = fork();
+  if(pid < 0){
+    fprintf(2, "strace: fork failed\n");
+    exit(1);
+  }
+  if(pid == 0){
+    schedctl(SCHEDCTL_STRACE, getpid());
+    exec(argv[i], argv + i);
+    fprintf(2, "strace: exec %s failed\n", argv[i]);
+    exit(1);
+  }
+
+  while(getprocinfo(pid, &info) == 0 && info.state != ZOMBIE){
+    nanosleep(200000);   // 20 ms
+    drain(!count);
+  }
+  schedctl(SCHEDCTL_STRACE, 0);
+  drain(!count);
+  if(count)
+    getsysstat(pid, h);
+  wait(0);
+  if(count)
+    table();
+  exit(0);
+}
@@ -0,0 +1,48 @@
+#include "kernel/types.h"
+#include "kernel/stat.h"
+#include "user/user.h"
+
+// time command [args...]
+// run command and report its timing, taken by waitx() as the
+// child is reaped.
+int
+main(int argc, char *argv[])
+{
+  struct procinfo info;
+  int pid, status;
+
+  if(argc < 2){
+    fprintf(2, "usage: time command [args...]\n");
+    exit(1);
+  }
+
+  pid = fork();
+  if(pid < 0){
+    fprintf(2, "time: fork failed\n");
+    exit(1);
+  }
+  if(pid == 0){
+    exec(argv[1], argv + 1);
+    fprintf(2, "time: exec %s failed\n", argv[1]);
+    exit(1);
+  }
+
+  if(waitx(&status, &info) != pid){
+    fprintf(2, "time: waitx failed\n");
+    exit(1);
+  }
+
+  // 10MHz clock: 10 units per microsecond
+  printf("real %lu us\n", (info.etime - info.ctime) / 10);
+  printf("user %lu us\n", info.utime / 10);
+  printf("sys  %lu us\n", info.ktime / 10);
+  printf("wait %lu us  (runnable, waiting for a CPU)\n", info.wtime / 10);
+  // instructions per cycle, in hundredths
+  printf("user %lu instructions, %lu cycles, IPC %lu.%02lu\n", info.instret, info.cycles,
+         info.cycles ? info.instret / info.cycles : 0,
+         info.cycles ? info.instret * 100 / info.cycles % 100 : 0);
+  printf("sleep %lu us\n", info.slptime / 10);
+  printf("%lu voluntary, %lu involuntary context switches\n",
+         info.nvcsw, info.nivcsw);
+  exit(status);
+}
@@ -159,3 +159,34 @@ sbrklazy(int n) {
   return sys_sbrk(n, SBRK_LAZY);
 }
 
+
+// The kernel lets user code read the time, cycle and instret
+// counters (scounteren), so these cost a few instructions
+// rather than a system call like sys_gettime().
+
+// the 10MHz clock.
+uint64
+gettime(void)
+{
+  uint64 x;
+  asm volatile("rdtime %0" : "=r" (x));
+  return x;
+}
+
+// this CPU's cycle counter.
+uint64
+getcycles(void)
+{
+  uint64 x;
+  asm volatile("rdcycle %0" : "=r" (x));
+  return x;
+}
+
+// this CPU's count of instructions retired.
+uint64
+getinstret(void)
+{
+  uint64 x;
+  asm volatile("rdinstret %0" : "=r" (x));
+  return x;
+}
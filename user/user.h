@@ -29,6 +29,28 @@ int yield(void);
 int setexpected(int ticks);
 int setstcfvals(int hint);
 int getprocinfo(int pid, struct procinfo *info);
+int yield_to(int pid);
+int send(int pid, const void *msg, int n);
+int recv(int *pid, void *buf, int n);
+int nice(int inc);
+int setpriority(int pid, int nice);
+int getpriority(int pid);
+int schedctl(int param, int val);
+int setpgid(int pid, int pgid);
+int setquota(int pgid, int quota, int period);
+int getpgroupinfo(int pgid, struct pgroupinfo *info);
+int getwaithist(int kind, int id, struct hist *h);
+int waitx(int *status, struct procinfo *info);
+int exitstats(struct exitstats *st, int reset);
+int getcpustats(struct cpustats *st, int n);
+void *mapstats(void);
+uint64 sys_gettime(void);
+int nanosleep(uint64 dur);
+int getprofile(struct profsample *buf, int n);
+int getsysstat(int pid, struct hist *h);
+int getstrace(struct straceent *buf, int n);
+int getlockstat(struct lockstat *buf, int n);
+int lockbench(int kind, int iters, int work);
 
 // ulib.c
 int stat(const char*, struct stat*);
@@ -44,6 +66,9 @@ int memcmp(const void *, const void *, uint);
 void *memcpy(void *, const void *, uint);
 char* sbrk(int);
 char* sbrklazy(int);
+uint64 gettime(void);
+uint64 getcycles(void);
+uint64 getinstret(void);
 
 // printf.c
 void fprintf(int, const char*, ...) __attribute__ ((format (printf, 2, 3)));
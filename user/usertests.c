@@ -7,6 +7,9 @@
 #include "kernel/syscall.h"
 #include "kernel/memlayout.h"
 #include "kernel/riscv.h"
+#include "kernel/statspage.h"
+#include "kernel/schedctl.h"
+#include "kernel/spinlock.h"
 
 //
 // Tests xv6 system calls.  usertests without arguments runs them all
@@ -2713,7 +2716,7 @@ lazy_sbrk(char *s)
     p = sbrklazy(0);
   }
 
-  int n = TRAPFRAME-PGSIZE-(uint64)p;
+  int n = USERTOP-PGSIZE-(uint64)p;
 
   char *p1 = sbrklazy(n);
   if (p1 < 0 || p1 != p) {
@@ -2722,8 +2725,8 @@ lazy_sbrk(char *s)
   }
 
   p = sbrk(PGSIZE);
-  if (p < 0 || (uint64)p != TRAPFRAME-PGSIZE) {
-    printf("sbrk(%d) returned %p, not expected TRAPFRAME-PGSIZE\n", PGSIZE, p);
+  if (p < 0 || (uint64)p != USERTOP-PGSIZE) {
+    printf("sbrk(%d) returned %p, not expected USERTOP-PGSIZE\n", PGSIZE, p);
     exit(1);
   }
 
@@ -2748,6 +2751,733 @@ lazy_sbrk(char *s)
   exit(0);
 }
 
+// nice values are clamped, settable by pid, and inherited by fork.
+void
+nicetest(char *s)
+{
+  int xst;
+
+  if(getpriority(0) != 0){
+    printf("%s: initial nice %d\n", s, getpriority(0));
+    exit(1);
+  }
+  if(nice(5) != 5 || getpriority(getpid()) != 5){
+    printf("%s: nice(5) failed\n", s);
+    exit(1);
+  }
+  if(nice(100) != 19 || nice(-100) != -20){
+    printf("%s: nice not clamped\n", s);
+    exit(1);
+  }
+  if(setpriority(getpid(), 7) != 0 || getpriority(0) != 7){
+    printf("%s: setpriority failed\n", s);
+    exit(1);
+  }
+  if(setpriority(1000000, 0) != -1){
+    printf("%s: setpriority of bad pid succeeded\n", s);
+    exit(1);
+  }
+
+  int pid = fork();
+  if(pid < 0){
+    printf("%s: fork failed\n", s);
+    exit(1);
+  }
+  if(pid == 0)
+    exit(getpriority(0));
+  wait(&xst);
+  if(xst != 7){
+    printf("%s: child nice %d, want 7\n", s, xst);
+    exit(1);
+  }
+  exit(0);
+}
+
+// under MLFQ, a process demoted for using the CPU moves back up
+// when it wakes from a disk wait. Other policies never demote,
+// so there is nothing to check.
+void
+ioboosttest(char *s)
+{
+  struct procinfo info;
+  uint64 t0 = gettime();
+
+  // spin until demoted, for up to 2 s.
+  do {
+    if(getprocinfo(getpid(), &info) < 0){
+      printf("%s: getprocinfo failed\n", s);
+      exit(1);
+    }
+  } while(info.queue_level == 0 && gettime() - t0 < 20000000);
+  if(info.queue_level == 0)
+    exit(0);
+
+  uint64 promoted = info.npromote;
+  int old = schedctl(SCHEDCTL_INTERACT, 0);   // any score earns the boost
+  int fd = open("ioboost", O_CREATE | O_WRONLY);
+  write(fd, "x", 1);   // the log commit waits for the disk
+  close(fd);
+  unlink("ioboost");
+  schedctl(SCHEDCTL_INTERACT, old);
+  if(getprocinfo(getpid(), &info) < 0 || info.npromote <= promoted){
+    printf("%s: demoted process not boosted after disk I/O\n", s);
+    exit(1);
+  }
+  exit(0);
+}
+
+// with more CPU hogs than CPUs, hogs wait RUNNABLE: their run
+// queue waits are recorded, and with a 1 ms threshold the
+// starvation watchdog flags some of them.
+void
+waithisttest(char *s)
+{
+  struct procinfo info;
+  struct hist h;
+  int pids[NCPU + 2], waited = 0, starved = 0;
+
+  int old = schedctl(SCHEDCTL_STARVE, 1);
+  for(int i = 0; i < NCPU + 2; i++){
+    pids[i] = fork();
+    if(pids[i] < 0){
+      printf("%s: fork failed\n", s);
+      exit(1);
+    }
+    if(pids[i] == 0)
+      for(;;)
+        ;
+  }
+  pause(10);
+  for(int i = 0; i < NCPU + 2; i++){
+    if(getwaithist(WAITHIST_PROC, pids[i], &h) == 0 && h.count > 0)
+      waited = 1;
+    if(getprocinfo(pids[i], &info) == 0 && info.nstarved > 0)
+      starved = 1;
+    kill(pids[i]);
+  }
+  for(int i = 0; i < NCPU + 2; i++)
+    wait(0);
+  schedctl(SCHEDCTL_STARVE, old);
+
+  if(!waited){
+    printf("%s: no run queue waits recorded\n", s);
+    exit(1);
+  }
+  if(!starved){
+    printf("%s: no hog flagged as starving\n", s);
+    exit(1);
+  }
+  if(getwaithist(WAITHIST_CPU, 0, &h) < 0 || h.count == 0 ||
+     getwaithist(WAITHIST_CPU, NCPU, &h) != -1){
+    printf("%s: bad CPU wait histogram\n", s);
+    exit(1);
+  }
+  exit(0);
+}
+
+// a CPU-bound process group over its quota gets throttled.
+void
+quotatest(char *s)
+{
+  struct pgroupinfo info;
+
+  if(setpgid(0, 0) != 0 || getpgroupinfo(getpid(), &info) != -1){
+    printf("%s: setpgid failed\n", s);
+    exit(1);
+  }
+  // 1ms of CPU every 50ms.
+  if(setquota(getpid(), 10000, 500000) != 0){
+    printf("%s: setquota failed\n", s);
+    exit(1);
+  }
+  int t0 = uptime();
+  while(uptime() - t0 < 5)
+    ;
+  if(getpgroupinfo(getpid(), &info) != 0 || info.nthrottled == 0 ||
+     info.throttled_time == 0){
+    printf("%s: group never throttled\n", s);
+    exit(1);
+  }
+  setquota(getpid(), 0, 0);
+  exit(0);
+}
+
+// a group's quota goes away with its last member, whether that
+// member is reaped or moves to another group.
+void
+quotafreetest(char *s)
+{
+  struct pgroupinfo info;
+
+  int pid = fork();
+  if(pid < 0){
+    printf("%s: fork failed\n", s);
+    exit(1);
+  }
+  if(pid == 0){
+    if(setpgid(0, 0) != 0 || setquota(getpid(), 10000, 500000) != 0)
+      exit(1);
+    exit(0);
+  }
+  wait(0);
+  if(getpgroupinfo(pid, &info) != -1){
+    printf("%s: quota outlived its group\n", s);
+    exit(1);
+  }
+
+  if(setpgid(0, 0) != 0 || setquota(getpid(), 10000, 500000) != 0){
+    printf("%s: setquota failed\n", s);
+    exit(1);
+  }
+  if(setpgid(0, getpid() + 1000) != 0 || getpgroupinfo(getpid(), &info) != -1){
+    printf("%s: quota outlived its group\n", s);
+    exit(1);
+  }
+  exit(0);
+}
+
+// quota groups can be added and removed over and over while
+// the scheduler looks up the running processes' groups.
+void
+quotachurntest(char *s)
+{
+  struct pgroupinfo info;
+  int pids[2];
+
+  for(int i = 0; i < 2; i++){
+    if((pids[i] = fork()) < 0){
+      printf("%s: fork failed\n", s);
+      exit(1);
+    }
+    if(pids[i] == 0){
+      setpgid(0, 0);
+      for(;;)
+        ;
+    }
+  }
+  for(int i = 0; i < 50; i++){
+    int pgid = pids[i % 2];
+    if(setquota(pgid, 10000, 500000) != 0 || getpgroupinfo(pgid, &info) != 0 ||
+       info.pgid != pgid){
+      printf("%s: setquota failed\n", s);
+      exit(1);
+    }
+    if(setquota(pgid, 0, 0) != 0 || getpgroupinfo(pgid, &info) != -1){
+      printf("%s: quota not removed\n", s);
+      exit(1);
+    }
+  }
+  for(int i = 0; i < 2; i++){
+    kill(pids[i]);
+    wait(0);
+  }
+  exit(0);
+}
+
+// waitx() reaps a child and reports its final, consistent timing.
+void
+waitxtest(char *s)
+{
+  struct procinfo info;
+  int xst;
+
+  int pid = fork();
+  if(pid < 0){
+    printf("%s: fork failed\n", s);
+    exit(1);
+  }
+  if(pid == 0){
+    int t0 = uptime();
+    while(uptime() - t0 < 2)
+      ;
+    pause(1);
+    exit(3);
+  }
+  if(waitx(&xst, &info) != pid || xst != 3 || info.pid != pid){
+    printf("%s: waitx returned wrong child\n", s);
+    exit(1);
+  }
+  if(info.ctime == 0 || info.stime < info.ctime || info.etime < info.stime ||
+     info.rtime == 0 || info.rtime != info.utime + info.ktime ||
+     info.rtime > info.etime - info.ctime){
+    printf("%s: inconsistent times\n", s);
+    exit(1);
+  }
+  if(info.slptime == 0 || info.nvcsw == 0){
+    printf("%s: sleep not accounted\n", s);
+    exit(1);
+  }
+  if(waitx(0, &info) != -1){
+    printf("%s: waitx with no children succeeded\n", s);
+    exit(1);
+  }
+  exit(0);
+}
+
+// every exiting process is counted in the exit statistics.
+void
+exitstatstest(char *s)
+{
+  static struct exitstats before, after;
+
+  if(exitstats(&before, 0) != 0){
+    printf("%s: exitstats failed\n", s);
+    exit(1);
+  }
+  for(int i = 0; i < 3; i++){
+    int pid = fork();
+    if(pid < 0){
+      printf("%s: fork failed\n", s);
+      exit(1);
+    }
+    if(pid == 0)
+      exit(0);
+    wait(0);
+  }
+  exitstats(&after, 0);
+  if(after.turnaround.count < before.turnaround.count + 3 ||
+     after.response.count != after.turnaround.count ||
+     after.turnaround.max < after.response.max){
+    printf("%s: exits not counted\n", s);
+    exit(1);
+  }
+  exit(0);
+}
+
+// the statistics page lists this process, is shared with
+// children, and can't be written.
+void
+statspagetest(char *s)
+{
+  struct statspage *sp = mapstats();
+  int xst;
+
+  if(sp == (void *)-1 || mapstats() != sp){
+    printf("%s: mapstats failed\n", s);
+    exit(1);
+  }
+  pause(2);
+  int found = 0;
+  for(int i = 0; i < NPROC; i++)
+    if(sp->proc[i].pid == getpid())
+      found = 1;
+  if(!found){
+    printf("%s: own pid not in statistics page\n", s);
+    exit(1);
+  }
+
+  int pid = fork();
+  if(pid < 0){
+    printf("%s: fork failed\n", s);
+    exit(1);
+  }
+  if(pid == 0){
+    uint seq = sp->seq;
+    sp->seq = seq + 2;  // should be killed here
+    exit(0);
+  }
+  wait(&xst);
+  if(xst != -1){
+    printf("%s: wrote read-only statistics page\n", s);
+    exit(1);
+  }
+  exit(0);
+}
+
+// /proc files are generated, read-only, and per-pid.
+void
+procfstest(char *s)
+{
+  char path[32], buf[256];
+  struct stat st;
+  int fd, n;
+
+  if(stat("/proc", &st) < 0 || st.type != T_DIR){
+    printf("%s: /proc is not a directory\n", s);
+    exit(1);
+  }
+  if((fd = open("/proc/loadavg", O_RDONLY)) < 0 || read(fd, buf, sizeof(buf)) <= 0){
+    printf("%s: cannot read /proc/loadavg\n", s);
+    exit(1);
+  }
+  close(fd);
+
+  // /proc/<pid>/status, read a byte at a time
+  strcpy(path, "/proc/");
+  n = strlen(path);
+  int pid = getpid();
+  char digits[8];
+  int nd = 0;
+  do {
+    digits[nd++] = '0' + pid % 10;
+  } while((pid /= 10) > 0);
+  while(nd > 0)
+    path[n++] = digits[--nd];
+  strcpy(path + n, "/status");
+  if((fd = open(path, O_RDONLY)) < 0){
+    printf("%s: cannot open %s\n", s, path);
+    exit(1);
+  }
+  for(n = 0; n < sizeof(buf) - 1 && read(fd, buf + n, 1) == 1; n++)
+    ;
+  buf[n] = 0;
+  close(fd);
+  if(memcmp(buf, "Name:\tusertests", 15) != 0){
+    printf("%s: bad status %s\n", s, buf);
+    exit(1);
+  }
+
+  if(open("/proc/loadavg", O_RDWR) >= 0 || open("/proc/0/status", O_RDONLY) >= 0 ||
+     open("/proc/nosuchfile", O_RDONLY) >= 0){
+    printf("%s: opened a bad /proc path\n", s);
+    exit(1);
+  }
+  exit(0);
+}
+
+// gettime() never goes backwards and advances across a sleep.
+void
+gettimetest(char *s)
+{
+  uint64 t0 = gettime(), t1 = t0;
+
+  for(int i = 0; i < 1000; i++){
+    uint64 t = gettime();
+    if(t < t1){
+      printf("%s: gettime went backwards\n", s);
+      exit(1);
+    }
+    t1 = t;
+  }
+  pause(1);
+  if(gettime() <= t1){
+    printf("%s: gettime did not advance\n", s);
+    exit(1);
+  }
+
+  // the user-mode clock is the one the kernel reads.
+  t0 = gettime();
+  t1 = sys_gettime();
+  if(t1 < t0 || gettime() < t1){
+    printf("%s: gettime and sys_gettime disagree\n", s);
+    exit(1);
+  }
+  exit(0);
+}
+
+// user-mode instructions are counted per process.
+void
+instrettest(char *s)
+{
+  struct procinfo info;
+  uint64 i0 = getinstret();
+
+  for(volatile int i = 0; i < 100000; i++)
+    ;
+  if(getinstret() - i0 < 100000){
+    printf("%s: instret did not advance\n", s);
+    exit(1);
+  }
+  if(getprocinfo(getpid(), &info) < 0 || info.instret < 100000 || info.cycles == 0){
+    printf("%s: instret %lu cycles %lu not accounted\n", s, info.instret, info.cycles);
+    exit(1);
+  }
+  exit(0);
+}
+
+// each return to user space after a sleep records a latency.
+void
+wakelattest(char *s)
+{
+  struct hist h;
+
+  for(int i = 0; i < 3; i++)
+    pause(1);
+  if(getwaithist(WAKEHIST_PROC, getpid(), &h) < 0){
+    printf("%s: getwaithist failed\n", s);
+    exit(1);
+  }
+  if(h.count < 3 || h.min > h.max || h.sum < h.count * h.min){
+    printf("%s: bad wakeup histogram, count %lu\n", s, h.count);
+    exit(1);
+  }
+  exit(0);
+}
+
+// nanosleep() sleeps at least as long as asked, and a
+// killed sleeper wakes up.
+void
+nanosleeptest(char *s)
+{
+  for(int i = 0; i < 5; i++){
+    uint64 t0 = gettime();
+    if(nanosleep(20000) < 0 || gettime() - t0 < 20000){   // 2 ms
+      printf("%s: woke up early\n", s);
+      exit(1);
+    }
+  }
+
+  int pid = fork();
+  if(pid < 0){
+    printf("%s: fork failed\n", s);
+    exit(1);
+  }
+  if(pid == 0){
+    nanosleep(1000000000);   // 100 s
+    exit(0);
+  }
+  pause(1);
+  uint64 t0 = gettime();
+  kill(pid);
+  wait(0);
+  if(gettime() - t0 > 50000000){
+    printf("%s: killed sleeper did not wake\n", s);
+    exit(1);
+  }
+  exit(0);
+}
+
+// the profiler samples a spinning process in user mode.
+void
+proftest(char *s)
+{
+  struct profsample buf[16];
+  int n, found = 0;
+
+  if(schedctl(SCHEDCTL_PROFILE, 1) != -1){
+    printf("%s: 1us profiler interval accepted\n", s);
+    exit(1);
+  }
+  while(getprofile(buf, 16) > 0)
+    ;
+  int old = schedctl(SCHEDCTL_PROFILE, 1000);   // 1 ms
+  uint64 t0 = gettime();
+  while(gettime() - t0 < 500000)   // 50 ms
+    ;
+  schedctl(SCHEDCTL_PROFILE, old);
+  while((n = getprofile(buf, 16)) > 0){
+    for(int i = 0; i < n; i++)
+      if(buf[i].pid == getpid() && buf[i].user)
+        found++;
+  }
+  if(n < 0 || found == 0){
+    printf("%s: no user-mode samples of this process\n", s);
+    exit(1);
+  }
+  exit(0);
+}
+
+// system calls are counted per process; the traced process's
+// are timed in full and logged with their arguments.
+void
+stracetest(char *s)
+{
+  static struct hist h[NSYSCALL];
+  struct straceent e[8];
+  int n, found = 0, up[2], down[2];
+  char c;
+
+  if(pipe(up) < 0 || pipe(down) < 0){
+    printf("%s: pipe failed\n", s);
+    exit(1);
+  }
+  int pid = fork();
+  if(pid < 0){
+    printf("%s: fork failed\n", s);
+    exit(1);
+  }
+  if(pid == 0){
+    int oldtime = schedctl(SCHEDCTL_SYSTIME, 1);
+    for(int i = 0; i < 10; i++)
+      getpid();
+    schedctl(SCHEDCTL_SYSTIME, oldtime);
+    write(up[1], "x", 1);
+    read(down[0], &c, 1);   // until the parent has looked
+    exit(0);
+  }
+  read(up[0], &c, 1);
+  if(getsysstat(pid, h) < 0 || h[SYS_getpid].count < 10 || h[SYS_getpid].max != 0){
+    printf("%s: untraced child's getpid not counted\n", s);
+    exit(1);
+  }
+  write(down[1], "x", 1);
+  wait(0);
+  close(up[0]);
+  close(up[1]);
+  close(down[0]);
+  close(down[1]);
+
+  while(getstrace(e, 8) > 0)
+    ;
+  int oldpid = schedctl(SCHEDCTL_STRACE, getpid());
+  for(int i = 0; i < 10; i++)
+    getpid();
+  close(open("README", O_RDONLY));
+  if(getsysstat(getpid(), h) < 0 || h[SYS_getpid].count != 10 ||
+     h[SYS_getpid].max < h[SYS_getpid].min){
+    printf("%s: getpid not counted\n", s);
+    exit(1);
+  }
+  schedctl(SCHEDCTL_STRACE, oldpid);
+  while((n = getstrace(e, 8)) > 0){
+    for(int i = 0; i < n; i++)
+      if(e[i].pid == getpid() && e[i].num == SYS_open &&
+         strcmp(e[i].str, "README") == 0 && e[i].arg[1] == O_RDONLY && (int)e[i].ret >= 0)
+        found++;
+  }
+  if(n < 0 || found != 1){
+    printf("%s: open not traced\n", s);
+    exit(1);
+  }
+  exit(0);
+}
+
+// lock classes come back most contended first, and the process
+// table's spinlocks and the inode table's rwlock have been taken.
+void
+lockstattest(char *s)
+{
+  static struct lockstat st[NLOCKCLASS];
+  int n, proc = 0, itable = 0;
+
+  if((n = getlockstat(st, NLOCKCLASS)) <= 0){
+    printf("%s: getlockstat failed\n", s);
+    exit(1);
+  }
+  for(int i = 0; i < n; i++){
+    if(i > 0 && st[i].ncontended > st[i-1].ncontended){
+      printf("%s: %s out of order\n", s, st[i].name);
+      exit(1);
+    }
+    if(st[i].ncontended > st[i].nacquire){
+      printf("%s: %s contended more than acquired\n", s, st[i].name);
+      exit(1);
+    }
+    if(strcmp(st[i].name, "proc") == 0 && st[i].nacquire > 0)
+      proc = 1;
+    if(strcmp(st[i].name, "itable") == 0 && st[i].nacquire > 0)
+      itable = 1;
+  }
+  if(!proc || !itable){
+    printf("%s: no %s lock acquisitions\n", s, proc ? "itable" : "proc");
+    exit(1);
+  }
+  exit(0);
+}
+
+// concurrent processes can take a kernel lock of each kind,
+// and every acquisition is counted.
+void
+lockkindtest(char *s)
+{
+  static struct lockstat st[NLOCKCLASS];
+  char *names[] = { "bench-tas", "bench-ticket", "bench-mcs" };
+  uint64 before[3] = { 0, 0, 0 };
+  int n, status;
+
+  if(lockbench(LOCK_TAS, LOCKBENCH_MAXITERS + 1, 0) != -1 ||
+     lockbench(LOCK_TAS, 1, LOCKBENCH_MAXWORK + 1) != -1){
+    printf("%s: oversized lockbench accepted\n", s);
+    exit(1);
+  }
+  n = getlockstat(st, NLOCKCLASS);
+  for(int i = 0; i < n; i++)
+    for(int k = 0; k < 3; k++)
+      if(strcmp(st[i].name, names[k]) == 0)
+        before[k] = st[i].nacquire;
+
+  for(int c = 0; c < 3; c++){
+    int pid = fork();
+    if(pid < 0){
+      printf("%s: fork failed\n", s);
+      exit(1);
+    }
+    if(pid == 0){
+      for(int k = LOCK_TAS; k <= LOCK_MCS; k++)
+        if(lockbench(k, 2000, 5) < 0)
+          exit(1);
+      exit(0);
+    }
+  }
+  for(int c = 0; c < 3; c++){
+    wait(&status);
+    if(status != 0){
+      printf("%s: lockbench failed\n", s);
+      exit(1);
+    }
+  }
+
+  n = getlockstat(st, NLOCKCLASS);
+  for(int k = 0; k < 3; k++){
+    int i;
+    for(i = 0; i < n; i++)
+      if(strcmp(st[i].name, names[k]) == 0)
+        break;
+    if(i == n || st[i].nacquire - before[k] < 3 * 2000){
+      printf("%s: %s acquisitions missing\n", s, names[k]);
+      exit(1);
+    }
+  }
+  exit(0);
+}
+
+// processes contending for one file's inode and buffer
+// sleeplocks all get through, and the waits are counted.
+void
+sleeplocktest(char *s)
+{
+  static struct lockstat st[NLOCKCLASS];
+  char buf[512];
+  int fd, n, status;
+
+  memset(buf, 'q', sizeof(buf));
+  if((fd = open("sleeplock.tmp", O_CREATE | O_WRONLY)) < 0 ||
+     write(fd, buf, sizeof(buf)) != sizeof(buf)){
+    printf("%s: create failed\n", s);
+    exit(1);
+  }
+  close(fd);
+
+  for(int c = 0; c < 4; c++){
+    int pid = fork();
+    if(pid < 0){
+      printf("%s: fork failed\n", s);
+      exit(1);
+    }
+    if(pid == 0){
+      for(int i = 0; i < 100; i++){
+        memset(buf, 0, sizeof(buf));
+        if((fd = open("sleeplock.tmp", O_RDONLY)) < 0 ||
+           read(fd, buf, sizeof(buf)) != sizeof(buf) || buf[0] != 'q' || buf[511] != 'q')
+          exit(1);
+        close(fd);
+      }
+      exit(0);
+    }
+  }
+  for(int c = 0; c < 4; c++){
+    wait(&status);
+    if(status != 0){
+      printf("%s: reader failed\n", s);
+      exit(1);
+    }
+  }
+  unlink("sleeplock.tmp");
+
+  n = getlockstat(st, NLOCKCLASS);
+  for(int i = 0; i < n; i++){
+    if(strcmp(st[i].name, "inode") == 0){
+      if(st[i].nsleepacq < 4 * 100 || st[i].nspun + st[i].nslept > st[i].nsleepacq){
+        printf("%s: bad inode sleeplock counts\n", s);
+        exit(1);
+      }
+      exit(0);
+    }
+  }
+  printf("%s: no inode lock class\n", s);
+  exit(1);
+}
+
 struct test {
   void (*f)(char *);
   char *s;
@@ -2812,6 +3542,25 @@ struct test {
   {sbrklast, "sbrklast"},
   {sbrk8000, "sbrk8000"},
   {badarg, "badarg" },
+  {nicetest, "nicetest" },
+  {ioboosttest, "ioboosttest" },
+  {waithisttest, "waithisttest" },
+  {quotatest, "quotatest" },
+  {waitxtest, "waitxtest" },
+  {exitstatstest, "exitstatstest" },
+  {statspagetest, "statspagetest" },
+  {procfstest, "procfstest" },
+  {gettimetest, "gettimetest" },
+  {instrettest, "instrettest" },
+  {wakelattest, "wakelattest" },
+  {nanosleeptest, "nanosleeptest" },
+  {proftest, "proftest" },
+  {stracetest, "stracetest" },
+  {lockstattest, "lockstattest" },
+  {lockkindtest, "lockkindtest" },
+  {quotachurntest, "quotachurntest" },
+  {quotafreetest, "quotafreetest" },
+  {sleeplocktest, "sleeplocktest" },
   {lazy_alloc, "lazy_alloc"},
   {lazy_unmap, "lazy_unmap"},
   {lazy_copy, "lazy_copy"},
@@ -9,7 +9,7 @@ print "#include \"kernel/syscall.h\"\n";
 sub entry {
     my $prefix = "sys_";
     my $name = shift;
-    if ($name eq "sbrk") {
+    if ($name eq "sbrk" || $name eq "gettime") {
 	print ".global $prefix$name\n";
 	print "$prefix$name:\n";
     } else {
@@ -46,3 +46,25 @@ entry("setexpected");
 entry("setstcfvals");
 entry("yield");
 entry("getprocinfo");
+entry("yield_to");
+entry("send");
+entry("recv");
+entry("nice");
+entry("setpriority");
+entry("getpriority");
+entry("schedctl");
+entry("setpgid");
+entry("setquota");
+entry("getpgroupinfo");
+entry("getwaithist");
+entry("waitx");
+entry("exitstats");
+entry("getcpustats");
+entry("mapstats");
+entry("gettime");
+entry("nanosleep");
+entry("getprofile");
+entry("getsysstat");
+entry("getstrace");
+entry("getlockstat");
+entry("lockbench");
@@ -0,0 +1,43 @@
+#include "kernel/types.h"
+#include "kernel/stat.h"
+#include "kernel/param.h"
+#include "user/user.h"
+
+// waithist [pid]
+// print the run-queue wait histogram of process pid,
+// or of every CPU if no pid is given.
+
+void
+print(char *what, int id, struct hist *h)
+{
+  printf("%s %d: %lu waits, mean %lu us, max %lu us\n", what, id,
+         h->count, h->count ? h->sum / h->count / 10 : 0, h->max / 10);
+  for(int i = 0; i < NHIST; i++){
+    if(h->bucket[i] == 0)
+      continue;
+    // bucket i holds waits below 2^i clock units (0.1 us each)
+    printf("  < %lu us: %lu\n", ((1UL << i) + 9) / 10, h->bucket[i]);
+  }
+}
+
+int
+main(int argc, char *argv[])
+{
+  struct hist h;
+
+  if(argc > 1){
+    int pid = atoi(argv[1]);
+    if(getwaithist(WAITHIST_PROC, pid, &h) < 0){
+      fprintf(2, "waithist: no process %d\n", pid);
+      exit(1);
+    }
+    print("pid", pid, &h);
+    exit(0);
+  }
+
+  for(int cpu = 0; cpu < NCPU; cpu++){
+    if(getwaithist(WAITHIST_CPU, cpu, &h) == 0 && h.count > 0)
+      print("cpu", cpu, &h);
+  }
+  exit(0);
+}
@@ -0,0 +1,253 @@
+#include "kernel/types.h"
+#include "kernel/stat.h"
+#include "kernel/fcntl.h"
+#include "kernel/fs.h"
+#include "user/user.h"
+#include "user/workload.h"
+
+// Workload generator for schedeval; see workload.h.
+// Times are in 10MHz clock units unless noted.
+
+#define MS   10000ULL     // clock units per millisecond
+#define TICK 1000000ULL   // clock units per timer interrupt
+
+static uint64 state = 1;
+static uint64 loops_per_ms;
+
+// Seed the generator. The same seed gives the same arrivals.
+void
+wl_seed(uint64 seed)
+{
+  state = seed ? seed : 1;
+}
+
+// xorshift64*
+uint64
+wl_rand(void)
+{
+  state ^= state >> 12;
+  state ^= state << 25;
+  state ^= state >> 27;
+  return state * 2685821657736338717ULL;
+}
+
+// log2(x) in 16.16 fixed point, for x > 0.
+static uint64
+log2fix(uint64 x)
+{
+  int k = 63;
+  uint64 frac = 0;
+
+  while(((x >> k) & 1) == 0)
+    k--;
+  // normalize x into [1, 2) with 16 fraction bits, then take
+  // a bit of the logarithm each time it is squared.
+  uint64 y = k >= 16 ? x >> (k - 16) : x << (16 - k);
+  for(int i = 15; i >= 0; i--){
+    y = (y * y) >> 16;
+    if(y >= (2 << 16)){
+      y >>= 1;
+      frac |= 1 << i;
+    }
+  }
+  return ((uint64)k << 16) | frac;
+}
+
+// An exponentially distributed value with the given mean,
+// for Poisson arrivals: -mean * ln(u) for u uniform in (0, 1].
+uint64
+wl_exp(uint64 mean)
+{
+  uint64 u = (wl_rand() >> 32) + 1;          // (0, 2^32]
+  uint64 nlog2 = (32ULL << 16) - log2fix(u);  // -log2(u / 2^32)
+  return (mean * nlog2 * 45426) >> 32;       // ln 2 = 45426 / 2^16
+}
+
+static void
+spin(uint64 n)
+{
+  for(volatile uint64 i = 0; i < n; i++)
+    ;
+}
+
+// Measure how many spin() iterations make a millisecond of CPU,
+// taking the fastest of a few runs as the one that was not
+// preempted. CPU phases then burn a fixed amount of work rather
+// than watching the clock, so time spent preempted is not
+// counted as running.
+void
+wl_calibrate(void)
+{
+  uint64 n = 100000, best = 0;
+
+  for(int i = 0; i < 5; i++){
+    uint64 t0 = gettime();
+    spin(n);
+    uint64 t = gettime() - t0;
+    if(t == 0){
+      n *= 10;
+      i--;
+      continue;
+    }
+    if(best == 0 || t < best)
+      best = t;
+  }
+  loops_per_ms = n * MS / best;
+  if(loops_per_ms == 0)
+    loops_per_ms = 1;
+}
+
+// Compute for ms milliseconds of CPU time.
+void
+wl_cpu(int ms)
+{
+  if(loops_per_ms == 0)
+    wl_calibrate();
+  spin(loops_per_ms * ms);
+}
+
+// "wl.<pid>"
+static void
+tmpname(char *buf)
+{
+  char digits[8];
+  int pid = getpid(), n = 0;
+
+  strcpy(buf, "wl.");
+  buf += 3;
+  do {
+    digits[n++] = '0' + pid % 10;
+  } while((pid /= 10) > 0);
+  while(n > 0)
+    *buf++ = digits[--n];
+  *buf = 0;
+}
+
+static void
+disk(int kb)
+{
+  static char buf[BSIZE];
+  char name[16];
+  int fd;
+
+  tmpname(name);
+  if((fd = open(name, O_CREATE | O_RDWR | O_TRUNC)) < 0){
+    fprintf(2, "workload: cannot create %s\n", name);
+    exit(1);
+  }
+  for(int i = 0; i < kb; i++)
+    write(fd, buf, sizeof(buf));
+  close(fd);
+  if((fd = open(name, O_RDONLY)) >= 0){
+    while(read(fd, buf, sizeof(buf)) > 0)
+      ;
+    close(fd);
+  }
+  unlink(name);
+}
+
+// Write kb KB through a pipe to a child that reads it, blocking
+// whenever the pipe is full.
+static void
+pipeio(int kb)
+{
+  static char buf[BSIZE];
+  int fds[2];
+
+  if(pipe(fds) < 0){
+    fprintf(2, "workload: pipe failed\n");
+    exit(1);
+  }
+  int pid = fork();
+  if(pid < 0){
+    fprintf(2, "workload: fork failed\n");
+    exit(1);
+  }
+  if(pid == 0){
+    close(fds[1]);
+    while(read(fds[0], buf, sizeof(buf)) > 0)
+      ;
+    exit(0);
+  }
+  close(fds[0]);
+  for(int i = 0; i < kb; i++)
+    write(fds[1], buf, sizeof(buf));
+  close(fds[1]);
+  wait(0);
+}
+
+// The body of a job's process.
+static void
+runjob(struct job *j)
+{
+  if(j->nice)
+    nice(j->nice);
+  if(j->hint){
+    setexpected(j->hint * MS);
+    setstcfvals(j->hint * MS);
+  }
+  for(struct phase *ph = j->phase; ph < &j->phase[WL_MAXPHASE] && ph->kind != W_END; ph++){
+    switch(ph->kind){
+    case W_CPU:
+      wl_cpu(ph->amount);
+      break;
+    case W_DISK:
+      disk(ph->amount);
+      break;
+    case W_PIPE:
+      pipeio(ph->amount);
+      break;
+    case W_SLEEP:
+      pause(ph->amount);
+      break;
+    }
+  }
+  printf("%s done (pid=%d)\n", j->name, getpid());
+  exit(0);
+}
+
+// Wait until clock time t without taking a CPU from the jobs.
+static void
+waituntil(uint64 t)
+{
+  uint64 now;
+
+  while((now = gettime()) < t){
+    if(t - now > TICK)
+      pause(1);
+    else
+      yield();
+  }
+}
+
+// Fork the jobs of s as their arrivals come up, recording their
+// pids in pids. Returns the number of jobs started; the caller
+// reaps them.
+int
+wl_run(struct scenario *s, int *pids)
+{
+  uint64 at;
+  int n;
+
+  if(loops_per_ms == 0)
+    wl_calibrate();
+
+  at = gettime();
+  for(n = 0; n < WL_MAXJOB && s->job[n].name; n++){
+    struct job *j = &s->job[n];
+    if(s->arrival == WL_FIXED)
+      at += j->arrive * MS;
+    else if(n > 0 && (s->arrival == WL_POISSON || s->burst <= 0 || n % s->burst == 0))
+      at += wl_exp(s->mean * MS);
+    waituntil(at);
+
+    pids[n] = fork();
+    if(pids[n] < 0){
+      fprintf(2, "workload: fork failed\n");
+      break;
+    }
+    if(pids[n] == 0)
+      runjob(j);
+  }
+  return n;
+}
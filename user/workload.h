@@ -0,0 +1,50 @@
+// Synthetic workloads for evaluating the schedulers.
+//
+// A scenario is a table of jobs. Each job is forked when its
+// arrival comes up, sets its runtime hint and nice value, and
+// then runs its phases in order: calibrated CPU bursts that are
+// preempted like real computation, file and pipe I/O, and sleeps.
+
+#define WL_MAXJOB   12
+#define WL_MAXPHASE 10
+
+// phase kinds
+#define W_END   0
+#define W_CPU   1   // amount: ms of CPU time
+#define W_DISK  2   // amount: KB written to a file, then read back
+#define W_PIPE  3   // amount: KB written through a pipe to a reader
+#define W_SLEEP 4   // amount: clock ticks to pause()
+
+struct phase {
+  int kind;
+  int amount;
+};
+
+struct job {
+  char *name;           // 0 ends the table
+  int arrive;           // WL_FIXED: ms after the previous arrival
+  int hint;             // expected CPU ms for SJF/STCF; 0 for none
+  int nice;
+  struct phase phase[WL_MAXPHASE];
+};
+
+// arrival schedules
+#define WL_FIXED   0    // job.arrive
+#define WL_POISSON 1    // exponential gaps with mean ms
+#define WL_BURSTY  2    // groups of burst jobs, exponential gaps between groups
+
+struct scenario {
+  char *name;
+  char *desc;
+  int arrival;
+  int mean;             // ms, for WL_POISSON and WL_BURSTY
+  int burst;            // jobs per group, for WL_BURSTY
+  struct job job[WL_MAXJOB];
+};
+
+void   wl_seed(uint64 seed);
+uint64 wl_rand(void);
+uint64 wl_exp(uint64 mean);
+void   wl_calibrate(void);
+void   wl_cpu(int ms);
+int    wl_run(struct scenario *s, int *pids);